@@ -0,0 +1,272 @@
+// Search benchmark over the fixed position corpus in bench/positions.txt.
+// Every position is searched from a cold engine at each requested depth;
+// the results are printed as JSON so runs can be diffed against a baseline.
+//
+// Every search also counts its heap allocations through the replaced global
+// operator new below. The search is meant to allocate nothing; with
+// --check-allocs a search that did makes the bench exit with status 1.
+//
+// --eval searches with the learned pattern evaluator and the given weight
+// file instead of shape evaluation.
+//
+// Usage: gomoku_ai_bench [--corpus file] [--depths 2,4,6] [--threads n] [--no-threats]
+//                        [--beam width[,root_width]] [--eval weights] [--check-allocs]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "SearchEngine.hpp"
+#include "PatternWeights.hpp"
+
+#ifndef GOMOKU_BENCH_CORPUS
+#define GOMOKU_BENCH_CORPUS "bench/positions.txt"
+#endif
+
+using Pieces = std::vector<std::pair<int, int>>;
+
+// Allocation-counting hook: every operator new of the process goes through
+// here. The whole family is replaced, aligned and nothrow forms included, so
+// every block is allocated by malloc / aligned_alloc and released by free.
+static std::atomic<unsigned long long> heap_allocations(0);
+
+static void* counted_alloc(std::size_t size, std::size_t alignment) noexcept {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    if (alignment <= alignof(std::max_align_t)) {
+        return std::malloc(size);
+    }
+    // aligned_alloc wants a multiple of the alignment
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+static void* counted_alloc_or_throw(std::size_t size, std::size_t alignment) {
+    if (void* block = counted_alloc(size, alignment)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) {
+    return counted_alloc_or_throw(size, 0);
+}
+
+void* operator new[](std::size_t size) {
+    return counted_alloc_or_throw(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return counted_alloc_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return counted_alloc_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, 0);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete[](void* block) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t) noexcept { std::free(block); }
+void operator delete(void* block, std::align_val_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { std::free(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { std::free(block); }
+void operator delete(void* block, std::align_val_t, const std::nothrow_t&) noexcept { std::free(block); }
+void operator delete[](void* block, std::align_val_t, const std::nothrow_t&) noexcept { std::free(block); }
+
+struct Position {
+    std::string name;
+    std::string category;
+    int size = 0;
+    Pieces ai;
+    Pieces human;
+};
+
+// "ai:1,2;3,4" -> {{1,2},{3,4}}
+static bool parse_stones(const std::string& field, const std::string& label, Pieces& out) {
+    if (field.compare(0, label.size(), label) != 0) {
+        return false;
+    }
+    std::stringstream list(field.substr(label.size()));
+    std::string stone;
+    while (std::getline(list, stone, ';')) {
+        int x, y;
+        if (std::sscanf(stone.c_str(), "%d,%d", &x, &y) != 2) {
+            return false;
+        }
+        out.push_back({x, y});
+    }
+    return true;
+}
+
+static std::vector<Position> load_corpus(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("[Error] Cannot open corpus " + path);
+    }
+
+    std::vector<Position> positions;
+    std::string line;
+    for (int line_no = 1; std::getline(in, line); line_no++) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::stringstream fields(line);
+        std::string ai_field, human_field;
+        Position pos;
+        if (!(fields >> pos.name >> pos.category >> pos.size >> ai_field >> human_field) ||
+            !parse_stones(ai_field, "ai:", pos.ai) || !parse_stones(human_field, "human:", pos.human)) {
+            throw std::runtime_error("[Error] " + path + ":" + std::to_string(line_no) + ": malformed position");
+        }
+        if (!search_engine_supports(pos.size, pos.size)) {
+            throw std::runtime_error("[Error] " + path + ":" + std::to_string(line_no) + ": unsupported board size");
+        }
+        positions.push_back(pos);
+    }
+    return positions;
+}
+
+int main(int argc, char** argv) {
+    std::string corpus = GOMOKU_BENCH_CORPUS;
+    std::vector<int> depths = {2, 4, 6};
+    int threads = 1;
+    int beam = 0;
+    int root_beam = 0;
+    bool threats = true;
+    bool check_allocs = false;
+    std::string eval_path;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--corpus" && i + 1 < argc) {
+            corpus = argv[++i];
+        } else if (arg == "--depths" && i + 1 < argc) {
+            depths.clear();
+            std::stringstream list(argv[++i]);
+            std::string depth;
+            while (std::getline(list, depth, ',')) {
+                depths.push_back(std::atoi(depth.c_str()));
+            }
+        } else if (arg == "--beam" && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%d,%d", &beam, &root_beam) < 1) {
+                beam = 0;
+            }
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (arg == "--no-threats") {
+            threats = false;
+        } else if (arg == "--eval" && i + 1 < argc) {
+            eval_path = argv[++i];
+        } else if (arg == "--check-allocs") {
+            check_allocs = true;
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--corpus file] [--depths 2,4,6] [--threads n] [--no-threats] "
+                         "[--beam width[,root_width]] [--eval weights] [--check-allocs]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<Position> positions;
+    std::shared_ptr<PatternWeights> weights;
+    try {
+        positions = load_corpus(corpus);
+        if (!eval_path.empty()) {
+            weights = std::make_shared<PatternWeights>();
+            if (!weights->load(eval_path)) {
+                std::fprintf(stderr, "[Error] Cannot open evaluation weights %s\n", eval_path.c_str());
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    long long total_nodes = 0;
+    double total_ms = 0;
+    unsigned long long total_allocations = 0;
+
+    std::printf("{\n  \"corpus\": \"%s\",\n  \"threads\": %d,\n  \"threat_search\": %s,\n  \"beam\": [%d, %d],\n"
+                "  \"eval\": \"%s\",\n  \"search_stats\": %s,\n  \"positions\": [\n",
+                corpus.c_str(), threads, threats ? "true" : "false", beam, root_beam,
+                eval_path.empty() ? "shapes" : eval_path.c_str(), GOMOKU_SEARCH_STATS ? "true" : "false");
+    for (std::size_t p = 0; p < positions.size(); p++) {
+        const Position& pos = positions[p];
+        std::printf("    {\"name\": \"%s\", \"category\": \"%s\", \"size\": %d, \"stones\": %zu, \"runs\": [\n",
+                    pos.name.c_str(), pos.category.c_str(), pos.size, pos.ai.size() + pos.human.size());
+
+        for (std::size_t d = 0; d < depths.size(); d++) {
+            auto minimax = make_search_engine({pos.size, pos.size}, depths[d], 1.0);
+            minimax->set_threads(threads);
+            minimax->set_threat_search(threats);
+            minimax->set_beam(beam, root_beam);
+            minimax->set_evaluator(weights);
+
+            unsigned long long allocations_before = heap_allocations.load();
+            auto start = std::chrono::steady_clock::now();
+            auto move = minimax->get_next_move(pos.ai, pos.human);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            unsigned long long allocations = heap_allocations.load() - allocations_before;
+            total_allocations += allocations;
+
+            const SearchStats& stats = minimax->get_search_stats();
+            long long nodes = static_cast<long long>(stats.nodes);
+            total_nodes += nodes;
+            total_ms += ms;
+
+            std::printf("      {\"depth\": %d, \"move\": [%d, %d], \"time_ms\": %.3f, \"nodes\": %lld, "
+                        "\"nodes_per_sec\": %.0f, \"cutoff_ratio\": %.4f, \"tt_hit_rate\": %.4f, "
+                        "\"evaluations\": %llu, \"threat_nodes\": %llu, \"branching_factor\": %.2f, \"allocations\": %llu, "
+                        "\"nodes_per_ply\": [",
+                        depths[d], move.first, move.second, ms, nodes, ms > 0 ? nodes * 1000.0 / ms : 0.0,
+                        nodes > 0 ? static_cast<double>(stats.cutoffs) / nodes : 0.0,
+                        stats.tt_probes > 0 ? static_cast<double>(stats.tt_hits) / stats.tt_probes : 0.0,
+                        static_cast<unsigned long long>(stats.evaluations),
+                        static_cast<unsigned long long>(stats.threat_nodes), stats.effective_branching_factor(),
+                        allocations);
+            for (int ply = 0; ply < std::min(depths[d], SearchStats::MAX_PLY); ply++) {
+                std::printf("%s%llu", ply ? ", " : "", static_cast<unsigned long long>(stats.nodes_at_ply[ply]));
+            }
+            std::printf("]}%s\n", d + 1 < depths.size() ? "," : "");
+        }
+        std::printf("    ]}%s\n", p + 1 < positions.size() ? "," : "");
+    }
+    std::printf("  ],\n  \"total\": {\"nodes\": %lld, \"time_ms\": %.3f, \"nodes_per_sec\": %.0f, \"allocations\": %llu}\n}\n",
+                total_nodes, total_ms, total_ms > 0 ? total_nodes * 1000.0 / total_ms : 0.0, total_allocations);
+    if (check_allocs && total_allocations > 0) {
+        std::fprintf(stderr, "[Error] searches made %llu heap allocations\n", total_allocations);
+        return 1;
+    }
+    return 0;
+}
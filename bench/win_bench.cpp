@@ -0,0 +1,170 @@
+// Microbenchmark for win detection and four scanning.
+// Compares the original std::find based check_win against the bitboard
+// scan, and the bitboard scan under every SIMD kernel this CPU supports.
+//
+// Usage: gomoku_win_bench [board_size 9|15|19] [positions] [rounds]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+#include "Bitboard.hpp"
+#include "SearchEngine.hpp"
+#include "WinScan.hpp"
+
+using Pieces = std::vector<std::pair<int, int>>;
+
+// check_win as it was before the bitboard, kept here as the reference point
+static bool legacy_check_win(const Pieces& pieces, int COLUMN, int ROW) {
+    auto has = [&](int m, int n) {
+        return std::find(pieces.begin(), pieces.end(), std::make_pair(m, n)) != pieces.end();
+    };
+    for (int m = 0; m < COLUMN; m++) {
+        for (int n = 0; n < ROW; n++) {
+            if (n < ROW - 4 && has(m, n) && has(m, n + 1) && has(m, n + 2) && has(m, n + 3) && has(m, n + 4)) {
+                return true;
+            } else if (m < COLUMN - 4 && has(m, n) && has(m + 1, n) && has(m + 2, n) && has(m + 3, n) &&
+                       has(m + 4, n)) {
+                return true;
+            } else if (m < COLUMN - 4 && n < ROW - 4 && has(m, n) && has(m + 1, n + 1) && has(m + 2, n + 2) &&
+                       has(m + 3, n + 3) && has(m + 4, n + 4)) {
+                return true;
+            } else if (m < COLUMN - 4 && n > 3 && has(m, n) && has(m + 1, n - 1) && has(m + 2, n - 2) &&
+                       has(m + 3, n - 3) && has(m + 4, n - 4)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <int SIZE>
+struct Position {
+    Pieces pieces[2];
+    Bitboard<SIZE, SIZE> board;
+};
+
+template <int SIZE>
+static std::vector<Position<SIZE>> make_positions(int count) {
+    const int size = SIZE;
+    std::mt19937 rng(12345);
+    std::vector<Position<SIZE>> positions(count);
+    for (auto& p : positions) {
+        int stones = 10 + static_cast<int>(rng() % (size * size / 3));
+        for (int i = 0; i < stones; i++) {
+            int x = rng() % size;
+            int y = rng() % size;
+            if (!p.board.is_empty(x, y)) {
+                continue;
+            }
+            p.board.place(x, y, i & 1);
+            p.pieces[i & 1].push_back({x, y});
+        }
+    }
+    return positions;
+}
+
+template <typename F>
+static double time_ns(int calls, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / calls;
+}
+
+template <int SIZE>
+static int run(int count, int rounds) {
+    const int size = SIZE;
+    auto positions = make_positions<SIZE>(count);
+    auto minimax = make_search_engine({size, size});
+    long long sink = 0;
+
+    std::printf("board %dx%d, %d positions\n\n", size, size, count);
+    std::printf("%-28s %12s\n", "check", "ns/position");
+
+    // The std::find scan is orders of magnitude slower; one round is plenty
+    double legacy = time_ns(count, [&] {
+        for (const auto& p : positions) {
+            sink += legacy_check_win(p.pieces[0], size, size);
+        }
+    });
+    std::printf("%-28s %12.1f\n", "check_win (std::find)", legacy);
+
+    double rebuilt = time_ns(count * rounds, [&] {
+        for (int r = 0; r < rounds; r++) {
+            for (const auto& p : positions) {
+                sink += minimax->check_win(p.pieces[0]);
+            }
+        }
+    });
+    std::printf("%-28s %12.1f\n", "check_win (bitboard)", rebuilt);
+
+    const win_scan::Impl impls[] = {win_scan::Impl::Scalar, win_scan::Impl::SSE2, win_scan::Impl::AVX2,
+                                    win_scan::Impl::NEON};
+    std::vector<int> expected_five, expected_four;
+    int mismatches = 0;
+
+    for (auto impl : impls) {
+        if (!win_scan::available(impl)) {
+            continue;
+        }
+        win_scan::select(impl);
+
+        std::vector<int> five, four;
+        for (const auto& p : positions) {
+            five.push_back(p.board.has_five(0));
+            four.push_back(win_scan::first_four(p.board.line_data(0), p.board.line_data(1),
+                                                p.board.outside_data(), p.board.line_count()));
+        }
+        if (expected_five.empty()) {
+            expected_five = five;
+            expected_four = four;
+        }
+        mismatches += (five != expected_five) + (four != expected_four);
+
+        double has_five = time_ns(count * rounds, [&] {
+            for (int r = 0; r < rounds; r++) {
+                for (const auto& p : positions) {
+                    sink += p.board.has_five(r & 1);
+                }
+            }
+        });
+        double first_four = time_ns(count * rounds, [&] {
+            for (int r = 0; r < rounds; r++) {
+                for (const auto& p : positions) {
+                    int side = r & 1;
+                    sink += win_scan::first_four(p.board.line_data(side), p.board.line_data(1 - side),
+                                                 p.board.outside_data(), p.board.line_count());
+                }
+            }
+        });
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "has_five (%s)", win_scan::name(impl));
+        std::printf("%-28s %12.1f\n", label, has_five);
+        std::snprintf(label, sizeof(label), "first_four (%s)", win_scan::name(impl));
+        std::printf("%-28s %12.1f\n", label, first_four);
+    }
+    win_scan::select(win_scan::best_available());
+
+    std::printf("\nkernel mismatches: %d (checksum %lld)\n", mismatches, sink);
+    return mismatches == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    int size = argc > 1 ? std::atoi(argv[1]) : 15;
+    int count = argc > 2 ? std::atoi(argv[2]) : 2000;
+    int rounds = argc > 3 ? std::atoi(argv[3]) : 200;
+    if (count >= 1 && rounds >= 1) {
+        switch (size) {
+            case 9:  return run<9>(count, rounds);
+            case 15: return run<15>(count, rounds);
+            case 19: return run<19>(count, rounds);
+        }
+    }
+    std::fprintf(stderr, "[Error] usage: %s [board_size 9|15|19] [positions] [rounds]\n", argv[0]);
+    return 1;
+}
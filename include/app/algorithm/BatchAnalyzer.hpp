@@ -0,0 +1,86 @@
+#ifndef BATCH_ANALYZER_H
+#define BATCH_ANALYZER_H
+
+#include <vector>
+#include <utility>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "SearchEngine.hpp"
+#include "SearchStats.hpp"
+#include "HelperThreads.hpp"
+
+// Best move and score for many positions at once, for offline analysis.
+//
+// A batch is one contiguous array of boards, cells() bytes each, in row-major
+// order (x * rows + y): 0 for an empty cell, 1 for a stone of the side to move,
+// 2 for a stone of the other side. Positions are handed out to a fixed set of
+// workers, one thread each. Every worker keeps its own engine and piece lists
+// across positions and batches, so after the first batch nothing is allocated
+// per position. By default every position is searched from a cleared
+// transposition table and move ordering, so a result is the same as from a
+// fresh engine with the same table size whatever the thread count;
+// set_warm(true) keeps them instead. Worker tables default to 1 MB, so the
+// clear stays cheap next to a short search.
+// A board has no move order, so move ordering sees the stones in board order
+// rather than in the order they were played.
+class BatchAnalyzer {
+public:
+    struct Result {
+        std::pair<int, int> move;
+        int score; // SearchStats::score, for the side to move
+        int depth; // SearchStats::depth
+    };
+
+    // threads = 0 uses every hardware thread; throws std::invalid_argument
+    // for a board size the engine is not built for
+    BatchAnalyzer(std::pair<int, int> board_size, int search_depth = 3, int threads = 0, double attack_ratio = 1.0);
+
+    // Search count boards into results[0, count); throws std::invalid_argument
+    // for a cell value other than 0, 1 or 2
+    void evaluate(const uint8_t* boards, std::size_t count, Result* results);
+    std::vector<Result> evaluate(const std::vector<uint8_t>& boards);
+
+    // Options of every worker engine
+    void set_time_limit(int milliseconds);
+    void set_threat_search(bool enabled);
+    void set_tt_size(std::size_t megabytes);
+
+    // Keep the transposition table and move ordering from one position to
+    // the next: faster on related positions, but a result then depends on
+    // what the worker searched before (default off)
+    void set_warm(bool enabled) { warm = enabled; }
+
+    std::size_t cells() const { return CELLS; }
+    int threads() const { return static_cast<int>(workers.size()); }
+
+    // Last evaluate(): wall time, throughput and the counters of all searches
+    double elapsed_ms() const { return last_ms; }
+    double positions_per_second() const;
+    const SearchStats& get_search_stats() const { return stats; }
+
+private:
+    struct Worker {
+        std::unique_ptr<SearchEngine> engine;
+        SearchEngine::Pieces player_pieces;
+        SearchEngine::Pieces opponent_pieces;
+        SearchStats stats;
+    };
+
+    int ROW;
+    std::size_t CELLS;
+    std::vector<std::unique_ptr<Worker>> workers;
+    HelperThreads pool; // one thread per worker but the first
+    bool warm;
+
+    // Last batch
+    std::size_t last_count;
+    double last_ms;
+    SearchStats stats;
+
+    void run_worker(Worker& worker, const uint8_t* boards, std::size_t count, Result* results,
+                    std::atomic<std::size_t>& next);
+};
+
+#endif // BATCH_ANALYZER_H
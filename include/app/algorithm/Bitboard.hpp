@@ -0,0 +1,191 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include <array>
+#include <utility>
+#include <algorithm>
+
+// Constants shared by every board size
+struct BitboardBase {
+    static constexpr int MAX_LINE = 32;
+
+    // Zobrist key xor-ed in when the opponent (side 1) is to move
+    static constexpr uint64_t SIDE_KEY = 0x9E3779B97F4A7C15ull;
+
+    // Line directions, matching the (x_direct, y_direct) pairs used by the evaluation
+    enum Direction { ROW_LINE = 0, COLUMN_LINE, DIAG_LINE, ANTI_LINE, DIRECTIONS };
+};
+
+// Packed two-sided board used by the search.
+// Every row, column and diagonal of the board is stored as one bit mask per
+// side, so occupancy tests are a shift and an AND, and five-in-a-row detection
+// is the classic m & m>>1 & m>>2 & m>>3 & m>>4 over each line.
+//
+// Coordinates follow MinimaxAlgorithm: x in [0, COLUMNS), y in [0, ROWS).
+// Inside every line the bit index is y (x for columns), so consecutive bits
+// are always consecutive cells along the line. The dimensions are template
+// parameters, so the line tables and Zobrist keys are built at compile time.
+template <int COLUMNS, int ROWS>
+class Bitboard : public BitboardBase {
+    static_assert(COLUMNS >= 1 && ROWS >= 1 && COLUMNS <= MAX_LINE && ROWS <= MAX_LINE,
+                  "Bitboard supports 1 to 32 cells per line");
+
+public:
+    static constexpr int COLUMN = COLUMNS;
+    static constexpr int ROW = ROWS;
+    static constexpr int CELLS = COLUMNS * ROWS;
+    // Rows, columns, then both diagonal directions
+    static constexpr int LINES = COLUMNS + ROWS + 2 * (COLUMNS + ROWS - 1);
+
+    Bitboard();
+
+    // Remove every stone
+    void clear();
+
+    // Make / unmake a stone for side 0 or 1
+    void place(int x, int y, int side);
+    void remove(int x, int y, int side);
+
+    static constexpr bool in_bounds(int x, int y) { return x >= 0 && x < COLUMN && y >= 0 && y < ROW; }
+    bool has_stone(int x, int y, int side) const;
+    bool is_empty(int x, int y) const;
+
+    // Any stone of either side in the 8 cells around (x, y)
+    bool has_neighbor(int x, int y) const;
+
+    // Five (or more) in a row for side anywhere on the board (SIMD scan)
+    bool has_five(int side) const;
+
+    // Would a stone of side on (x, y) complete five in a row
+    bool makes_five(int x, int y, int side) const;
+
+    // Some empty cell where a stone of side completes five (SIMD scan), -1 if none
+    int five_point(int side) const;
+
+    // 64-bit Zobrist key of the stones, updated on every place / remove
+    uint64_t hash() const { return key; }
+
+    // Line geometry: every line of every direction has one id in [0, line_count())
+    static constexpr int line_count() { return LINES; }
+    static constexpr int line_of(int dir, int x, int y);
+    static constexpr int bit_of(int dir, int x, int y) { return dir == COLUMN_LINE ? x : y; }
+    static constexpr int line_direction(int line) { return TABLE.dir[line]; }
+    uint32_t line_mask(int line, int side) const { return lines[side][line]; }
+    // All masks of one side, and the bits of each line that are off the board
+    const uint32_t* line_data(int side) const { return lines[side].data(); }
+    static const uint32_t* outside_data() { return TABLE.outside.data(); }
+    // Cell at a bit of a line, possibly off the board
+    static constexpr std::pair<int, int> cell_at(int line, int bit);
+    // First and last bit of a line that lie on the board
+    static constexpr std::pair<int, int> line_span(int line);
+
+    static constexpr int columns() { return COLUMN; }
+    static constexpr int rows() { return ROW; }
+
+private:
+    // Ids are laid out as rows (indexed by x), columns (by y),
+    // diagonals (x+k, y+k) by x - y + ROW - 1, then anti-diagonals (x+k, y-k) by x + y
+    static constexpr int LINE_BASE[DIRECTIONS] = {0, COLUMNS, COLUMNS + ROWS, COLUMNS + ROWS + (COLUMNS + ROWS - 1)};
+
+    struct LineTable {
+        std::array<int, LINES> dir{};
+        std::array<int, LINES> fixed{};
+        std::array<uint32_t, LINES> outside{};
+    };
+    static constexpr LineTable make_table();
+    static constexpr LineTable TABLE = make_table();
+
+    // Fixed-seed keys so they are identical from run to run
+    using ZobristKeys = std::array<std::array<uint64_t, CELLS>, 2>;
+    static constexpr ZobristKeys make_zobrist();
+    static constexpr ZobristKeys ZOBRIST = make_zobrist();
+
+    // Line masks per side
+    std::array<uint32_t, LINES> lines[2];
+    uint64_t key = 0;
+};
+
+template <int COLUMNS, int ROWS>
+constexpr int Bitboard<COLUMNS, ROWS>::line_of(int dir, int x, int y) {
+    switch (dir) {
+        case ROW_LINE:    return LINE_BASE[ROW_LINE] + x;
+        case COLUMN_LINE: return LINE_BASE[COLUMN_LINE] + y;
+        case DIAG_LINE:   return LINE_BASE[DIAG_LINE] + x - y + ROW - 1;
+        default:          return LINE_BASE[ANTI_LINE] + x + y;
+    }
+}
+
+template <int COLUMNS, int ROWS>
+constexpr std::pair<int, int> Bitboard<COLUMNS, ROWS>::cell_at(int line, int bit) {
+    int fixed = TABLE.fixed[line];
+    switch (TABLE.dir[line]) {
+        case ROW_LINE:    return {fixed, bit};
+        case COLUMN_LINE: return {bit, fixed};
+        case DIAG_LINE:   return {bit + fixed - (ROW - 1), bit};
+        default:          return {fixed - bit, bit};
+    }
+}
+
+template <int COLUMNS, int ROWS>
+constexpr std::pair<int, int> Bitboard<COLUMNS, ROWS>::line_span(int line) {
+    int fixed = TABLE.fixed[line];
+    switch (TABLE.dir[line]) {
+        case ROW_LINE:    return {0, ROW - 1};
+        case COLUMN_LINE: return {0, COLUMN - 1};
+        case DIAG_LINE:   return {std::max(0, ROW - 1 - fixed), std::min(ROW - 1, COLUMN + ROW - 2 - fixed)};
+        default:          return {std::max(0, fixed - COLUMN + 1), std::min(ROW - 1, fixed)};
+    }
+}
+
+template <int COLUMNS, int ROWS>
+constexpr typename Bitboard<COLUMNS, ROWS>::LineTable Bitboard<COLUMNS, ROWS>::make_table() {
+    LineTable table;
+    const int counts[DIRECTIONS] = {COLUMN, ROW, COLUMN + ROW - 1, COLUMN + ROW - 1};
+    for (int dir = 0; dir < DIRECTIONS; dir++) {
+        for (int i = 0; i < counts[dir]; i++) {
+            table.dir[LINE_BASE[dir] + i] = dir;
+            table.fixed[LINE_BASE[dir] + i] = i;
+        }
+    }
+
+    // Same spans as line_span(), which cannot read TABLE while it is being built
+    for (int line = 0; line < LINES; line++) {
+        int fixed = table.fixed[line];
+        int lo = 0;
+        int hi = table.dir[line] == COLUMN_LINE ? COLUMN - 1 : ROW - 1;
+        if (table.dir[line] == DIAG_LINE) {
+            lo = std::max(0, ROW - 1 - fixed);
+            hi = std::min(ROW - 1, COLUMN + ROW - 2 - fixed);
+        } else if (table.dir[line] == ANTI_LINE) {
+            lo = std::max(0, fixed - COLUMN + 1);
+            hi = std::min(ROW - 1, fixed);
+        }
+        uint32_t on_board = (hi >= 31 ? ~0u : (1u << (hi + 1)) - 1) & ~((1u << lo) - 1);
+        table.outside[line] = ~on_board;
+    }
+    return table;
+}
+
+template <int COLUMNS, int ROWS>
+constexpr typename Bitboard<COLUMNS, ROWS>::ZobristKeys Bitboard<COLUMNS, ROWS>::make_zobrist() {
+    // splitmix64
+    ZobristKeys keys{};
+    uint64_t state = 0x5EED0F60A0C0ull;
+    for (auto& side : keys) {
+        for (auto& k : side) {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            k = z ^ (z >> 31);
+        }
+    }
+    return keys;
+}
+
+// Board sizes the engine is built for (see SearchEngine.hpp)
+extern template class Bitboard<9, 9>;
+extern template class Bitboard<15, 15>;
+extern template class Bitboard<19, 19>;
+
+#endif // BITBOARD_H
@@ -0,0 +1,51 @@
+#ifndef CANDIDATE_SET_H
+#define CANDIDATE_SET_H
+
+#include <array>
+#include "MoveList.hpp"
+
+// Live set of empty cells within `radius` (Chebyshev distance) of any stone.
+// Every cell keeps a count of nearby stones; place() and remove() adjust the
+// counts around one cell, so the set is maintained in O(radius^2) per move
+// and remove() exactly undoes place(). Cells are indices x * ROW + y.
+template <int COLUMNS, int ROWS>
+class CandidateSet {
+public:
+    static constexpr int COLUMN = COLUMNS;
+    static constexpr int ROW = ROWS;
+    static constexpr int CELLS = COLUMNS * ROWS;
+
+    explicit CandidateSet(int radius = 1);
+
+    void clear();
+
+    // Make / unmake a stone on (x, y)
+    void place(int x, int y);
+    void remove(int x, int y);
+
+    int size() const { return cells.size(); }
+    bool empty() const { return cells.empty(); }
+    bool contains(int cell) const { return position[cell] >= 0; }
+    int radius() const { return RADIUS; }
+
+    // Cells in no particular order
+    const int* begin() const { return cells.begin(); }
+    const int* end() const { return cells.end(); }
+
+private:
+    int RADIUS;
+
+    MoveList<CELLS> cells;                 // dense set
+    std::array<int, CELLS> position;       // index in cells, -1 if absent
+    std::array<int, CELLS> near_count;     // stones within RADIUS
+    std::array<char, CELLS> occupied;
+
+    void insert(int cell);
+    void erase(int cell);
+};
+
+extern template class CandidateSet<9, 9>;
+extern template class CandidateSet<15, 15>;
+extern template class CandidateSet<19, 19>;
+
+#endif // CANDIDATE_SET_H
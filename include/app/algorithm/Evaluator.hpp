@@ -0,0 +1,29 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include "Bitboard.hpp"
+
+// Incremental static evaluation, kept in sync with the board a search plays
+// on: update() follows every place / remove, so score() is a read of a
+// running total. A five scores the five score of ShapeTable.hpp, so wins
+// look the same whatever the evaluator.
+// Implementations: ShapeEvaluator (hand-written shapes, the default) and
+// LinearEvaluator (learned pattern weights).
+template <int COLUMNS, int ROWS>
+class Evaluator {
+public:
+    using Board = Bitboard<COLUMNS, ROWS>;
+
+    virtual ~Evaluator() = default;
+
+    // Rescore everything from the board
+    virtual void reset(const Board& board) = 0;
+
+    // Call after a stone is placed on or removed from (x, y)
+    virtual void update(const Board& board, int x, int y) = 0;
+
+    // Score of side 0 or 1
+    virtual int score(int side) const = 0;
+};
+
+#endif // EVALUATOR_H
@@ -3,20 +3,96 @@
 
 #include <vector>
 #include <utility>
-#include "MinimaxAlgorithm.hpp"
+#include <map>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <cstdint>
+#include <string>
+#include <memory>
+#include "SearchEngine.hpp"
+#include "OpeningBook.hpp"
 
 class GomokuAI
 {
 public:
-    GomokuAI(int size);
+    // move_time_ms > 0 bounds every getBestMove() by iterative deepening,
+    // otherwise the search runs to a fixed depth.
+    // threads > 1 runs a parallel (Lazy SMP) search, 1 is deterministic.
+    // ponder lets startPondering() search the likely human replies in the background.
+    // size must be one the engine is built for (9, 15 or 19).
+    // engine picks alpha-beta (default) or Monte Carlo tree search.
+    GomokuAI(int size, int move_time_ms = 0, int threads = 1, bool ponder = false,
+             EngineType engine = EngineType::Minimax);
+    ~GomokuAI();
     void updateBoard(int row, int col, int player);
     std::pair<int, int> getBestMove();
-    bool checkWin(int player);
+
+    // getBestMove() on a search thread of its own. Ends pondering and any
+    // earlier search, which resolves to (-1, -1). Book and ponder moves come
+    // back ready. The board must not change until the future is ready, so
+    // updateBoard() cancels a running search first.
+    std::future<std::pair<int, int>> getBestMoveAsync();
+    // The running search resolves soon with the best move found so far
+    void interruptSearch();
+    // The running search resolves to (-1, -1), unless it had just finished;
+    // returns once it has stopped
+    void cancelSearch();
+    bool isSearching() const;
+
+    // Moves each search may make before it stops like an interrupt (playouts
+    // for MCTS), on top of the time limit. 0 (default) is no limit.
+    void setNodeLimit(uint64_t nodes);
+    // Cached by updateBoard(), which only checks the lines through the new stone
+    bool checkWin(int player) const;
+    bool isGameOver() const;
     int countPieces(int player) const;
 
+    // Map an opening book built by gomoku_book_gen; getBestMove() plays its
+    // moves while the position is in it. false if the file is missing or
+    // was built for another board size.
+    bool loadOpeningBook(const std::string &path);
+
+    // Evaluate with learned pattern weights built by gomoku_eval_train instead
+    // of hand-written shapes, in getBestMove() and pondering. false if the file
+    // is missing; throws std::runtime_error if it is not a weight file.
+    bool loadEvaluator(const std::string &path);
+
+    // Beam mode for both the move search and pondering: each node searches only
+    // its width best moves, the root root_width (0 = twice width). 0 turns it off.
+    void setBeam(int width, int root_width = 0);
+
+    // Call after the AI's move is on the board: searches the answer to each
+    // likely human reply while the human thinks. getBestMove() ends pondering
+    // and plays the cached answer if the human chose one of those replies.
+    void startPondering();
+    void stopPondering();
+
 private:
     int size;
-    std::vector<std::vector<int>> board;
-    MinimaxAlgorithm minimax;
+    std::vector<int> board;                      // row * size + col -> player, 0 if empty
+    std::vector<std::pair<int, int>> pieces[3];  // stones of player 1 and 2, in move order
+    int winner; // player with five in a row, 0 while the game is on
+    std::unique_ptr<SearchEngine> minimax; // engine for this board size, follows updateBoard() move by move
+    OpeningBook book;
+
+    // Asynchronous search
+    std::thread search_thread;
+    std::atomic<bool> search_stop;      // cancel: abandon the search
+    std::atomic<bool> search_interrupt; // interrupt: play the best move so far
+    std::atomic<bool> searching;
+
+    // Pondering
+    bool ponder;
+    std::unique_ptr<SearchEngine> ponderer; // same engine type, shares the transposition table with minimax
+    std::thread ponder_thread;
+    std::atomic<bool> ponder_stop;
+    std::size_t ponder_counts[3];                          // stones per player when pondering started
+    std::map<std::pair<int, int>, std::pair<int, int>> ponder_replies; // human reply -> AI answer
+
+    int countLine(int row, int col, int d_row, int d_col, int player) const;
+    void ponderLoop(std::vector<std::pair<int, int>> ai_pieces, std::vector<std::pair<int, int>> human_pieces);
+    bool findPonderHit(std::pair<int, int> &move) const;
+    bool findReadyMove(std::pair<int, int> &move) const;
 };
 #endif
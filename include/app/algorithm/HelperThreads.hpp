@@ -0,0 +1,50 @@
+#ifndef HELPER_THREADS_H
+#define HELPER_THREADS_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+// Threads kept alive from one parallel search to the next, so starting a
+// search neither creates threads nor allocates. run(count, task) calls
+// task(0) on the calling thread and task(1) .. task(count - 1) on pool
+// threads, and returns when every call has. Threads are created by start(),
+// or by run() when count grows past the largest seen so far.
+class HelperThreads {
+public:
+    HelperThreads() = default;
+    ~HelperThreads();
+
+    HelperThreads(const HelperThreads&) = delete;
+    HelperThreads& operator=(const HelperThreads&) = delete;
+
+    // Make sure run(count, ...) finds its threads waiting
+    void start(int count);
+
+    // The task must outlive the call; it is referenced, not copied
+    template <typename Task>
+    void run(int count, Task& task) {
+        dispatch(count, &task, [](void* context, int index) { (*static_cast<Task*>(context))(index); });
+    }
+
+private:
+    std::vector<std::thread> threads;
+    std::mutex lock;
+    std::condition_variable wake; // a new round or quit
+    std::condition_variable done; // the last pool thread of a round finished
+
+    // Current round, guarded by lock
+    uint64_t round = 0;
+    int helpers = 0;  // pool threads taking part: indices 1 .. helpers
+    int running = 0;  // of those, not finished yet
+    bool quit = false;
+    void* context = nullptr;
+    void (*call)(void*, int) = nullptr;
+
+    void dispatch(int count, void* task_context, void (*task_call)(void*, int));
+    void thread_main(int index);
+};
+
+#endif // HELPER_THREADS_H
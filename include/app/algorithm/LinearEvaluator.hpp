@@ -0,0 +1,71 @@
+#ifndef LINEAR_EVALUATOR_H
+#define LINEAR_EVALUATOR_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include "Bitboard.hpp"
+#include "Evaluator.hpp"
+#include "PatternWeights.hpp"
+#include "ShapeTable.hpp"
+
+// Incremental evaluation by learned pattern weights (see PatternWeights).
+// Every line is cut into 6-cell windows, one per start from the cell before
+// the line to five cells before its end; lines too short to hold a five are
+// skipped. Every empty cell has a level per direction, read from the 4 cells
+// on either side, and a cell pattern from its two best levels. A side scores
+// the sum of the weights of all its window and cell patterns.
+// A move touches the four lines through it: update() re-sums those lines, a
+// SIMD add over the gathered int16 weights, and rates again the cells up to 4
+// away along them.
+template <int COLUMNS, int ROWS>
+class LinearEvaluator final : public Evaluator<COLUMNS, ROWS> {
+public:
+    using Board = Bitboard<COLUMNS, ROWS>;
+    static constexpr int MAX_WINDOWS = Board::MAX_LINE;
+    static constexpr int FIVE_SCORE = shape_table::window_score(0x1F, 0);
+
+    explicit LinearEvaluator(std::shared_ptr<const PatternWeights> pattern_weights);
+
+    void reset(const Board& board) override;
+    void update(const Board& board, int x, int y) override;
+    int score(int side) const override { return total[side] + (fives[side] > 0 ? FIVE_SCORE : 0); }
+
+    // Patterns of the windows of a line seen from side, in line order; returns the count
+    static int line_patterns(const Board& board, int line, int side, int* patterns);
+
+    // Level of the empty cell (x, y) for side along direction dir
+    static int cell_level(const Board& board, int dir, int x, int y, int side);
+
+    // Cell pattern of the empty cell (x, y) for side
+    static int cell_pattern(const Board& board, int x, int y, int side);
+
+private:
+    std::shared_ptr<const PatternWeights> weights;
+    int total[2] = {0, 0};
+    int fives[2] = {0, 0}; // lines holding a five
+    std::array<int, Board::LINES> line_score[2] = {};
+    std::array<bool, Board::LINES> line_five[2] = {};
+    // Levels of every empty cell, LEVEL_BITS per direction, and the weights of all packings
+    static constexpr int LEVEL_BITS = 3;
+    static constexpr int LEVEL_MASK = (1 << LEVEL_BITS) - 1;
+    static constexpr int PACKED_LEVELS = 1 << (LEVEL_BITS * Board::DIRECTIONS);
+    static_assert(PatternWeights::LEVELS <= LEVEL_MASK + 1, "a level fits in LEVEL_BITS");
+    std::array<uint16_t, Board::CELLS> cell_levels[2] = {};
+    std::array<int16_t, Board::CELLS> cell_score[2] = {}; // 0 on occupied cells
+    std::array<int16_t, PACKED_LEVELS> packed_weight;
+
+    void rescore_line(const Board& board, int line, int side);
+    // Levels and scores of an empty cell for both sides
+    void rescore_cell(const Board& board, int x, int y);
+    void set_cell_score(int side, int cell, int score) {
+        total[side] += score - cell_score[side][cell];
+        cell_score[side][cell] = static_cast<int16_t>(score);
+    }
+};
+
+extern template class LinearEvaluator<9, 9>;
+extern template class LinearEvaluator<15, 15>;
+extern template class LinearEvaluator<19, 19>;
+
+#endif // LINEAR_EVALUATOR_H
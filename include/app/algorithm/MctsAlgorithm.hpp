@@ -0,0 +1,182 @@
+#ifndef MCTS_ALGORITHM_H
+#define MCTS_ALGORITHM_H
+
+#include <vector>
+#include <utility>
+#include <map>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <cstdint>
+#include "SearchEngine.hpp"
+#include "Bitboard.hpp"
+#include "CandidateSet.hpp"
+#include "ShapeEvaluator.hpp"
+#include "ThreatSearch.hpp"
+#include "MoveList.hpp"
+#include "SearchStats.hpp"
+#include "HelperThreads.hpp"
+
+// Monte Carlo tree search engine for a COLUMNS x ROWS board.
+//
+// UCT with priors (PUCT): a leaf is expanded into its best candidates by
+// shape evaluation (32, or the set_beam() widths), and the evaluation sets
+// the prior each child is explored with. Playouts finish the game with a pattern-biased
+// policy: complete a five, else block the opponent's five, else play a
+// random cell next to a stone.
+//
+// Threads share one tree. A thread descending through a node counts its visit
+// straight away and adds the result on the way back, so until then the visit
+// reads as a loss (virtual loss) and other threads spread to other moves.
+//
+// Nodes come from a preallocated pool; children of a node are one contiguous
+// block, so an expansion is a single atomic bump of the pool. The subtree of
+// the moves played is kept between moves: make_move() walks the root down
+// and the next search compacts that subtree into the spare pool.
+//
+// Without a time limit a search runs the playout count given to the
+// constructor. The transposition table size sets the memory of both pools;
+// PVS and aspiration windows do not apply and are ignored.
+template <int COLUMNS, int ROWS>
+class MctsAlgorithm : public SearchEngine {
+public:
+    // Constructor
+    MctsAlgorithm(int playouts = 20000, double attack_ratio = 1.0);
+
+    // Get the best move for AI
+    std::pair<int, int> get_next_move(const Pieces& player_pieces, const Pieces& opponent_pieces) override;
+
+    // Session use
+    void new_game() override;
+    void make_move(std::pair<int, int> pos, bool is_ai) override;
+    std::pair<int, int> get_next_move() override;
+
+    const SearchStats& get_search_stats() const override { return stats; }
+    std::map<std::string, int> get_statistics() const override;
+
+    // Search options
+    void set_tt_size(std::size_t megabytes) override;
+    void set_time_limit(int milliseconds) override;
+    void set_threads(int threads) override;
+    void set_candidate_radius(int radius) override;
+    void set_threat_search(bool enabled) override;
+    void set_pvs(bool) override {}
+    void set_aspiration(bool) override {}
+    // Priors are tempered for shape scores, so they stay on shape evaluation
+    void set_evaluator(std::shared_ptr<const PatternWeights>) override {}
+    void set_beam(int width, int root_width = 0) override;
+    void set_stop_signal(const std::atomic<bool>* signal) override;
+    void set_interrupt_signal(const std::atomic<bool>* signal) override;
+    void set_node_limit(uint64_t nodes) override;
+
+    // No transposition table: the tree is the memory of the search
+    std::shared_ptr<TranspositionTable> get_tt() const override { return nullptr; }
+    void set_tt(std::shared_ptr<TranspositionTable>) override {}
+
+    Pieces likely_moves(const Pieces& player_pieces, const Pieces& opponent_pieces, int count) override;
+
+    bool check_win(const Pieces& pieces) override;
+
+    int columns() const override { return COLUMN; }
+    int rows() const override { return ROW; }
+
+private:
+    // Board dimensions
+    static constexpr int COLUMN = COLUMNS;
+    static constexpr int ROW = ROWS;
+    static constexpr int CELLS = COLUMNS * ROWS;
+    static constexpr uint32_t NO_NODE = ~0u;
+
+    enum NodeState : uint8_t { LEAF = 0, EXPANDING, EXPANDED, POOL_FULL };
+
+    struct Node {
+        std::atomic<uint32_t> visits;  // including playouts still running
+        std::atomic<uint32_t> value;   // half points for the side that played move
+        uint32_t first_child;
+        float prior;
+        int16_t move;                  // cell, -1 at the root of a new game
+        uint8_t child_count;
+        uint8_t wins;                  // move completed five
+        std::atomic<uint8_t> state;
+    };
+
+    // Board of one search thread, walked down the tree and back every playout
+    struct Worker {
+        Bitboard<COLUMNS, ROWS> board;
+        CandidateSet<COLUMNS, ROWS> candidates;
+        ShapeEvaluator<COLUMNS, ROWS> evaluator;
+        MoveList<CELLS> path;          // tree nodes of this playout, as pool indices
+        MoveList<CELLS> played;        // stones placed by this playout, in order
+        std::mt19937_64 rng;
+        SearchStats stats;
+        int max_depth;
+    };
+
+    int PLAYOUTS;
+    double ratio;
+
+    // Search budget
+    int time_limit_ms;
+    int thread_count;
+    const std::atomic<bool>* stop_signal;
+    const std::atomic<bool>* interrupt_signal;
+    uint64_t node_limit; // playouts, 0 if none
+    std::chrono::steady_clock::time_point deadline;
+    std::atomic<int> playouts_left;
+
+    // Statistics
+    SearchStats stats;
+    int max_depth;
+
+    // Game state
+    Pieces player_pieces;
+    Pieces opponent_pieces;
+    MoveList<CELLS> all_pieces; // every stone as a cell, in move order
+    Bitboard<COLUMNS, ROWS> board; // side 0 = player_pieces, side 1 = opponent_pieces
+    CandidateSet<COLUMNS, ROWS> candidates;
+    ShapeEvaluator<COLUMNS, ROWS> evaluator;
+    int radius;
+
+    // Search tree: root is in pools[active], pools[1 - active] is the spare for compaction
+    std::unique_ptr<Node[]> pools[2];
+    uint32_t pool_size;
+    int active;
+    std::atomic<uint32_t> pool_used;
+    uint32_t root;
+    int root_side; // side to move at the root
+
+    // Children per expansion, below and at the root
+    int children;
+    int root_children;
+
+    // Threat-space search
+    ThreatSearch<COLUMNS, ROWS> threats;
+    bool use_threat_search;
+
+    // One worker per thread, made by set_threads()
+    std::vector<std::unique_ptr<Worker>> workers;
+    HelperThreads helper_threads;
+
+    // Algorithm methods
+    void load_position(const Pieces& player_pieces_input, const Pieces& opponent_pieces_input);
+    bool solve_threats(std::pair<int, int>& move);
+    void reset_tree(int side_to_move);
+    void compact_tree();
+    void init_node(Node& node, int move, float prior, bool wins);
+    void search();
+    void run_worker(Worker& worker);
+    bool budget_left();
+    void playout(Worker& worker);
+    uint32_t select_child(const Node& node) const;
+    void expand(Worker& worker, Node& node, int side, int width);
+    int rollout(Worker& worker, int side);
+    int evaluation(const ShapeEvaluator<COLUMNS, ROWS>& shapes, int side) const;
+};
+
+extern template class MctsAlgorithm<9, 9>;
+extern template class MctsAlgorithm<15, 15>;
+extern template class MctsAlgorithm<19, 19>;
+
+#endif // MCTS_ALGORITHM_H
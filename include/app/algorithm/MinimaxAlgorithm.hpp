@@ -8,51 +8,153 @@
 #include <algorithm>
 #include <tuple>
 #include <iostream>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <array>
+#include "SearchEngine.hpp"
+#include "Bitboard.hpp"
+#include "Evaluator.hpp"
+#include "ShapeEvaluator.hpp"
+#include "LinearEvaluator.hpp"
+#include "PatternWeights.hpp"
+#include "TranspositionTable.hpp"
+#include "ThreatSearch.hpp"
+#include "CandidateSet.hpp"
+#include "MoveList.hpp"
+#include "SearchStats.hpp"
+#include "HelperThreads.hpp"
 
-class MinimaxAlgorithm {
+// Alpha-beta engine for a COLUMNS x ROWS board. Board, line tables and move
+// lists are fixed-size arrays and helper threads are kept between moves, so a
+// search does not touch the heap; the options are documented on SearchEngine.
+template <int COLUMNS, int ROWS>
+class MinimaxAlgorithm : public SearchEngine {
 public:
-    // Constructor
-    MinimaxAlgorithm(std::pair<int, int> board_size = {12, 12}, int search_depth = 3, double attack_ratio = 1.0);
+    // Constructor; searches with table when given (helpers share the main
+    // search's), otherwise allocates a default-sized table of its own
+    MinimaxAlgorithm(int search_depth = 3, double attack_ratio = 1.0,
+                     std::shared_ptr<TranspositionTable> table = nullptr);
     
     // Get the best move for AI
-    std::pair<int, int> get_next_move(const std::vector<std::pair<int, int>>& player_pieces, 
-                               const std::vector<std::pair<int, int>>& opponent_pieces);
+    std::pair<int, int> get_next_move(const Pieces& player_pieces, const Pieces& opponent_pieces) override;
+
+    // Session use
+    void new_game() override;
+    void make_move(std::pair<int, int> pos, bool is_ai) override;
+    std::pair<int, int> get_next_move() override;
     
-    // Get statistics
-    std::map<std::string, int> get_statistics() const;
+    const SearchStats& get_search_stats() const override { return stats; }
+    std::map<std::string, int> get_statistics() const override;
+
+    // Search options
+    void set_tt_size(std::size_t megabytes) override;
+    void set_time_limit(int milliseconds) override;
+    void set_threads(int threads) override;
+    void set_candidate_radius(int radius) override;
+    void set_threat_search(bool enabled) override;
+    void set_pvs(bool enabled) override;
+    void set_aspiration(bool enabled) override;
+    void set_beam(int width, int root_width = 0) override;
+    void set_evaluator(std::shared_ptr<const PatternWeights> weights) override;
+    void set_stop_signal(const std::atomic<bool>* signal) override;
+    void set_interrupt_signal(const std::atomic<bool>* signal) override;
+    void set_node_limit(uint64_t nodes) override;
+
+    std::shared_ptr<TranspositionTable> get_tt() const override { return tt; }
+    void set_tt(std::shared_ptr<TranspositionTable> table) override;
 
-    bool check_win(const std::vector<std::pair<int, int>>& pieces);
+    Pieces likely_moves(const Pieces& player_pieces, const Pieces& opponent_pieces, int count) override;
+
+    bool check_win(const Pieces& pieces) override;
+
+    int columns() const override { return COLUMN; }
+    int rows() const override { return ROW; }
 
 private:
     // Board dimensions
-    int COLUMN;
-    int ROW;
+    static constexpr int COLUMN = COLUMNS;
+    static constexpr int ROW = ROWS;
+    static constexpr int CELLS = COLUMNS * ROWS;
     int DEPTH;
     double ratio;
     
+    // Iterative deepening
+    int time_limit_ms;
+    int root_depth;
+    int completed_depth;
+    bool stop_search;
+    int poll_count;
+    std::chrono::steady_clock::time_point deadline;
+    std::pair<int, int> root_move;
+    
     // Statistics
-    int cut_count;
-    int search_count;
+    SearchStats stats;
     
     // Game state
-    std::vector<std::pair<int, int>> player_pieces;
-    std::vector<std::pair<int, int>> opponent_pieces;
-    std::vector<std::pair<int, int>> all_pieces;
-    std::vector<std::pair<int, int>> all_positions;
+    Pieces player_pieces;
+    Pieces opponent_pieces;
+    MoveList<CELLS> all_pieces; // every stone as a cell, in move order
+    Bitboard<COLUMNS, ROWS> board; // side 0 = player_pieces, side 1 = opponent_pieces
+    CandidateSet<COLUMNS, ROWS> candidates; // empty cells near stones, kept in sync with board
     std::pair<int, int> next_move;
     
-    // Shape scores for pattern evaluation
-    std::vector<std::pair<int, std::vector<int>>> shape_score;
+    // Static evaluation: shapes (scores in ShapeTable.hpp) or learned pattern weights
+    std::unique_ptr<Evaluator<COLUMNS, ROWS>> evaluator; // kept in sync with board on make/unmake
+    std::shared_ptr<const PatternWeights> eval_weights;  // nullptr for shapes
+    std::shared_ptr<TranspositionTable> tt; // kept across moves, shared with helpers
+    
+    // Parallel search
+    int thread_count;
+    int helper_id;                              // 0 for the main search
+    const std::atomic<bool>* abort_signal;      // set by the main search to stop helpers
+    const std::atomic<bool>* stop_signal;       // set by the owner to stop the whole search
+    const std::atomic<bool>* interrupt_signal;  // set by the owner to end the search with its best move so far
+    uint64_t node_limit;                        // 0 if none
+    uint64_t search_nodes;                      // moves made by this search, counted even without stats
+    std::vector<std::unique_ptr<MinimaxAlgorithm>> helpers;
+    bool helpers_synced;                        // helpers hold this position and follow make_move
+    HelperThreads helper_threads;               // run the helpers, kept between moves
+    
+    // Threat-space search
+    ThreatSearch<COLUMNS, ROWS> threats;
+    bool use_threat_search;
+    MoveList<CELLS> root_moves; // if not empty, the only moves tried at the root
+    
+    // Move ordering
+    std::array<std::array<int, 2>, CELLS + 1> killers; // last two cutoff moves per ply, -1 if none
+    std::array<int, CELLS> history[2];                 // cutoff credit per side and cell
+    
+    // Search windows
+    bool use_pvs;
+    bool use_aspiration;
+    
+    // Beam mode, 0 if off
+    int beam_width;
+    int root_beam_width;
     
     // Algorithm methods
+    void load_position(const Pieces& player_pieces_input, const Pieces& opponent_pieces_input);
+    void reset_statistics();
+    bool solve_threats(std::pair<int, int>& move);
+    bool opponent_has_forced_win();
+    void run_search();
+    void parallel_search();
+    void helper_search();
+    void iterative_deepening();
+    bool time_up();
+    bool out_of_budget();
+    bool threats_out_of_budget();
     int negamax(bool is_ai, int depth, int alpha, int beta);
-    void order_moves(std::vector<std::pair<int, int>>& blank_list);
-    bool has_neighbor(const std::pair<int, int>& point);
+    void beam_prune(MoveList<CELLS>& moves, bool is_ai, int width);
+    void order_moves(MoveList<CELLS>& moves, int side, int ply, int tt_move);
+    void record_cutoff(int side, int ply, int cell, int depth);
+    void age_ordering();
     int evaluation(bool is_ai);
-    int cal_score(int m, int n, int x_direct, int y_direct, 
-                 const std::vector<std::pair<int, int>>& enemy_list, 
-                 const std::vector<std::pair<int, int>>& my_list, 
-                 std::vector<std::tuple<int, std::vector<std::pair<int, int>>, std::pair<int, int>>>& score_all_arr);
 };
 
-#endif // MINIMAX_ALGORITHM_H 
\ No newline at end of file
+extern template class MinimaxAlgorithm<9, 9>;
+extern template class MinimaxAlgorithm<15, 15>;
+extern template class MinimaxAlgorithm<19, 19>;
+
+#endif // MINIMAX_ALGORITHM_H
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef MOVE_LIST_H
+#define MOVE_LIST_H
+
+#include <array>
+#include <algorithm>
+
+// Fixed-capacity list of cells (x * ROW + y). Lives on the stack or inside
+// the engine, so building move lists in the search never allocates.
+template <int CAPACITY>
+class MoveList {
+public:
+    void push_back(int cell) { cells[count++] = cell; }
+    void pop_back() { count--; }
+    void clear() { count = 0; }
+    // Keep the first n cells
+    void resize(int n) { count = n; }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    int back() const { return cells[count - 1]; }
+    bool contains(int cell) const { return std::find(begin(), end(), cell) != end(); }
+
+    int& operator[](int i) { return cells[i]; }
+    int operator[](int i) const { return cells[i]; }
+
+    int* begin() { return cells.data(); }
+    int* end() { return cells.data() + count; }
+    const int* begin() const { return cells.data(); }
+    const int* end() const { return cells.data() + count; }
+
+private:
+    std::array<int, CAPACITY> cells;
+    int count = 0;
+};
+
+#endif // MOVE_LIST_H
@@ -0,0 +1,73 @@
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Read-only opening book, memory-mapped from a binary file.
+//
+// File layout (little-endian): a 24-byte Header followed by Entry records
+// sorted by key. Positions are keyed by a canonical hash: the smallest of
+// the hashes of the 8 rotations/reflections of the board, with stones split
+// into "side to move" and "other side", so one entry covers every symmetric
+// position and either colour. The move is stored in that canonical
+// orientation and mapped back on probe.
+//
+// Books are built offline by the gomoku_book_gen tool.
+class OpeningBook {
+public:
+    struct Header {
+        char magic[8];      // "GMKBOOK1"
+        uint32_t board_size;
+        uint32_t reserved;
+        uint64_t count;
+    };
+
+    struct Entry {
+        uint64_t key;
+        uint16_t move;      // canonical cell index x * size + y
+        uint16_t depth;     // depth the move was searched to
+        uint32_t reserved;
+    };
+
+    using Pieces = std::vector<std::pair<int, int>>;
+
+    OpeningBook() = default;
+    ~OpeningBook();
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    // Map a book file. false if the file does not exist; throws
+    // std::runtime_error if it exists but is not a valid book.
+    bool open(const std::string& path);
+    void close();
+
+    bool is_open() const { return entries != nullptr; }
+    int board_size() const { return size; }
+    std::size_t size_entries() const { return count; }
+
+    // Book move for the side owning to_move, false if the position is not in the book
+    bool probe(const Pieces& to_move, const Pieces& other, std::pair<int, int>& move) const;
+
+    // Canonical key of a position, and the symmetry that maps it to canonical form
+    static uint64_t canonical_key(int board_size, const Pieces& to_move, const Pieces& other, int& symmetry);
+
+    // Symmetry 0-7 of an n x n board: bit 2 swaps x/y, then bit 0 mirrors x, bit 1 mirrors y
+    static std::pair<int, int> transform(int symmetry, std::pair<int, int> pt, int n);
+    static std::pair<int, int> inverse(int symmetry, std::pair<int, int> pt, int n);
+
+    // Sort, drop duplicate keys (the deepest entry wins) and write a book file
+    static void write(const std::string& path, int board_size, std::vector<Entry> entries);
+
+private:
+    void* mapping = nullptr;
+    std::size_t mapping_size = 0;
+    const Entry* entries = nullptr;
+    std::size_t count = 0;
+    int size = 0;
+};
+
+#endif // OPENING_BOOK_H
@@ -0,0 +1,85 @@
+#ifndef PATTERN_WEIGHTS_H
+#define PATTERN_WEIGHTS_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include "ShapeTable.hpp"
+
+// Learned weights of LinearEvaluator, one int16 per pattern, and the
+// definition of the patterns. Both kinds of pattern are seen from one side,
+// with a cell holding nothing, a stone of that side, or "blocked": an enemy
+// stone or a cell off the board.
+//
+// Line patterns are 6-cell line windows, encoded in base 3 like ShapeTable
+// windows (cell i weighs 3^i; 1 mine, 2 blocked).
+// Cell patterns are empty cells rated by what a stone there would make in
+// each of the four lines through it, from the 4 cells on either side: a level
+// from NONE to FIVE (see Level). The two best levels of the four directions
+// make the pattern, so forks such as four-three have weights of their own.
+//
+// A side's score is the sum of the weights of the windows of every line and of
+// every empty cell, in evaluation units, so the weights are quantized to
+// integers once at training time and inference is integer adds only.
+//
+// File layout (little-endian): a 16-byte Header followed by LINE_PATTERNS and
+// then CELL_PATTERNS int16 weights. Weight files are built offline by the
+// gomoku_eval_train tool.
+class PatternWeights {
+public:
+    struct Header {
+        char magic[8];           // "GMKEVAL1"
+        uint32_t line_patterns;  // LINE_PATTERNS
+        uint32_t cell_patterns;  // CELL_PATTERNS
+    };
+
+    // What a stone makes along one line: a move completing a five or making
+    // another FOUR or FLEX4 (open four) in a row, THREE / FLEX3 a move away from
+    // a FOUR / FLEX4, TWO / FLEX2 a move away from a THREE / FLEX3
+    enum Level { NONE, TWO, FLEX2, THREE, FLEX3, FOUR, FLEX4, FIVE, LEVELS };
+
+    static constexpr int LINE_PATTERNS = shape_table::WINDOW_COUNT;
+    static constexpr int CELL_PATTERNS = LEVELS * LEVELS;
+
+    // Line pattern of the window starting at bit start of 64-bit line masks
+    static int line_pattern(uint64_t mine, uint64_t blocked, int start) {
+        return shape_table::BASE3[(mine >> start) & 0x3F] + 2 * shape_table::BASE3[(blocked >> start) & 0x3F];
+    }
+
+    // Same line pattern read in the other direction along the line
+    static constexpr int mirror(int pattern) {
+        int mirrored = 0;
+        for (int i = 0; i < shape_table::WINDOW; i++, pattern /= 3) {
+            mirrored = mirrored * 3 + pattern % 3;
+        }
+        return mirrored;
+    }
+
+    // Level of a stone on bit 4 of 9-bit masks of a line segment; the stone itself is not in the masks
+    static int level(uint32_t mine, uint32_t blocked);
+
+    // Cell pattern of the levels in the four directions
+    static int cell_pattern(const uint8_t levels[4]);
+
+    // All weights zero
+    PatternWeights() {
+        lines.fill(0);
+        cells.fill(0);
+    }
+
+    // Read a weight file. false if the file does not exist; throws
+    // std::runtime_error if it exists but is not a valid weight file.
+    bool load(const std::string& path);
+    void save(const std::string& path) const;
+
+    int16_t& line(int pattern) { return lines[pattern]; }
+    int16_t line(int pattern) const { return lines[pattern]; }
+    int16_t& cell(int pattern) { return cells[pattern]; }
+    int16_t cell(int pattern) const { return cells[pattern]; }
+
+private:
+    alignas(16) std::array<int16_t, LINE_PATTERNS> lines;
+    alignas(16) std::array<int16_t, CELL_PATTERNS> cells;
+};
+
+#endif // PATTERN_WEIGHTS_H
@@ -0,0 +1,125 @@
+#ifndef SEARCH_ENGINE_H
+#define SEARCH_ENGINE_H
+
+#include <vector>
+#include <utility>
+#include <map>
+#include <string>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include "SearchStats.hpp"
+#include "TranspositionTable.hpp"
+
+class PatternWeights;
+
+// Board-size independent face of a search engine.
+// The engines are templates on the board dimensions so every table and loop
+// bound is fixed at compile time; make_search_engine() picks the instantiation
+// for a board size at runtime. Built sizes: 9x9, 15x15 and 19x19.
+class SearchEngine {
+public:
+    using Pieces = std::vector<std::pair<int, int>>;
+
+    virtual ~SearchEngine() = default;
+
+    // Get the best move for AI; (-1, -1) if the board is full
+    virtual std::pair<int, int> get_next_move(const Pieces& player_pieces, const Pieces& opponent_pieces) = 0;
+
+    // Session use: the engine keeps the position and is fed one stone at a time,
+    // so nothing is rebuilt between moves. get_next_move() searches that position.
+    virtual void new_game() = 0;
+    virtual void make_move(std::pair<int, int> pos, bool is_ai) = 0;
+    virtual std::pair<int, int> get_next_move() = 0;
+
+    // Counters of the last get_next_move(); all zero when GOMOKU_SEARCH_STATS is off
+    virtual const SearchStats& get_search_stats() const = 0;
+
+    // The main counters by name, for quick printing
+    virtual std::map<std::string, int> get_statistics() const = 0;
+
+    // Resize the transposition table (clears it)
+    virtual void set_tt_size(std::size_t megabytes) = 0;
+
+    // Anytime mode: iterative deepening until the move budget runs out.
+    // 0 (default) searches to the fixed depth given at construction.
+    virtual void set_time_limit(int milliseconds) = 0;
+
+    // Lazy SMP: threads - 1 helper searches fill the shared transposition
+    // table while this thread searches. 1 (default) is plain single-threaded search.
+    virtual void set_threads(int threads) = 0;
+
+    // Moves searched are the empty cells within this distance of a stone (default 1)
+    virtual void set_candidate_radius(int radius) = 0;
+
+    // Look for forced wins (VCF/VCT) for both sides before the main search (default on).
+    // Its time counts against the move budget, and the search gives up when that runs out.
+    virtual void set_threat_search(bool enabled) = 0;
+
+    // Principal variation search: moves after the first are tried with a null
+    // window and re-searched only if they beat it (default on)
+    virtual void set_pvs(bool enabled) = 0;
+
+    // Iterative deepening starts each depth with a narrow window around the
+    // previous score and widens it on a fail (default on)
+    virtual void set_aspiration(bool enabled) = 0;
+
+    // Beam mode: a node expands only its width best candidates by static shape
+    // evaluation, the root its root_width best (0 = twice width). Moves that
+    // complete or block a five rank first. width 0 (default) expands all.
+    virtual void set_beam(int width, int root_width = 0) = 0;
+
+    // Static evaluation by learned pattern weights (LinearEvaluator) instead of
+    // hand-written shapes. nullptr (default) goes back to shapes. Weights are
+    // shared, not copied, so one loaded file serves any number of engines.
+    virtual void set_evaluator(std::shared_ptr<const PatternWeights> weights) = 0;
+
+    // External stop: a running get_next_move() gives up soon after *signal is set.
+    // The move it returns then is not reliable. nullptr (default) disables it.
+    virtual void set_stop_signal(const std::atomic<bool>* signal) = 0;
+
+    // Interrupt: a running get_next_move() finishes soon after *signal is set
+    // and returns the best move found so far, as if its budget ran out.
+    // nullptr (default) disables it.
+    virtual void set_interrupt_signal(const std::atomic<bool>* signal) = 0;
+
+    // Budget in moves made by the search (playouts for MCTS); reaching it ends
+    // the search like an interrupt. 0 (default) is no limit.
+    virtual void set_node_limit(uint64_t nodes) = 0;
+
+    // The transposition table searched with; engines of one board size can share it
+    virtual std::shared_ptr<TranspositionTable> get_tt() const = 0;
+    virtual void set_tt(std::shared_ptr<TranspositionTable> table) = 0;
+
+    // Search with the transposition table of other, so each warms it for the other
+    void share_tt(const SearchEngine& other) { set_tt(other.get_tt()); }
+
+    // Up to count moves for the side owning player_pieces, best first by static evaluation
+    virtual Pieces likely_moves(const Pieces& player_pieces, const Pieces& opponent_pieces, int count) = 0;
+
+    virtual bool check_win(const Pieces& pieces) = 0;
+
+    virtual int columns() const = 0;
+    virtual int rows() const = 0;
+};
+
+// Search algorithms behind SearchEngine
+enum class EngineType { Minimax, Mcts };
+
+// Whether an engine is built for this board size
+bool search_engine_supports(int columns, int rows);
+
+// Minimax engine for the board size, searching with table when given and with
+// a default-sized table of its own otherwise; throws std::invalid_argument for
+// a size that is not built
+std::unique_ptr<SearchEngine> make_search_engine(std::pair<int, int> board_size, int search_depth = 3,
+                                                 double attack_ratio = 1.0,
+                                                 std::shared_ptr<TranspositionTable> table = nullptr);
+
+// Monte Carlo tree search engine for the board size, playouts per move when
+// there is no time limit; throws like make_search_engine()
+std::unique_ptr<SearchEngine> make_mcts_engine(std::pair<int, int> board_size, int playouts = 20000,
+                                               double attack_ratio = 1.0);
+
+#endif // SEARCH_ENGINE_H
@@ -0,0 +1,80 @@
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+#include <cmath>
+#include <cstdint>
+
+// Search counters are compiled out unless GOMOKU_SEARCH_STATS is 1. By default
+// they follow NDEBUG, so Release builds pay nothing; the CMake option
+// GOMOKU_SEARCH_STATS=ON keeps them in optimised builds for benchmarking.
+#ifndef GOMOKU_SEARCH_STATS
+#ifdef NDEBUG
+#define GOMOKU_SEARCH_STATS 0
+#else
+#define GOMOKU_SEARCH_STATS 1
+#endif
+#endif
+
+#if GOMOKU_SEARCH_STATS
+#define SEARCH_STAT(statement) statement
+#else
+#define SEARCH_STAT(statement) do {} while (0)
+#endif
+
+// Counters of one get_next_move() call, helpers included. Plain data: the
+// layout is the same whether counting is compiled in or not, it just stays zero.
+struct SearchStats {
+    static constexpr int MAX_PLY = 64; // deeper plies are counted in the last slot
+
+    uint64_t nodes;                        // moves made by the search
+    uint64_t cutoffs;                      // beta cutoffs
+    uint64_t nodes_at_ply[MAX_PLY];
+    uint64_t cutoffs_at_ply[MAX_PLY];
+    uint64_t iteration_nodes[MAX_PLY];     // nodes of the main search per iterative-deepening depth
+    uint64_t tt_probes;
+    uint64_t tt_hits;
+    uint64_t tt_collisions;
+    uint64_t evaluations;                  // leaf evaluations
+    uint64_t threat_nodes;                 // VCF/VCT solver nodes
+    uint64_t pvs_researches;
+    uint64_t aspiration_researches;
+    uint64_t playouts;                     // MCTS playouts
+    uint64_t elapsed_us;
+    int32_t depth;                         // deepest completed iteration, 0 if a forced win was played
+    int32_t threads;
+    int32_t score;                         // of the move played, for the side to move (minimax: evaluation,
+                                           // MCTS: win rate in per mille); kept without GOMOKU_SEARCH_STATS
+
+    static int ply_slot(int ply) { return ply < MAX_PLY ? ply : MAX_PLY - 1; }
+
+    // Node growth from the second-deepest to the deepest completed iteration,
+    // or the depth-th root of all nodes when only one depth was searched
+    double effective_branching_factor() const {
+        if (depth <= 0 || nodes == 0) {
+            return 0.0;
+        }
+        int last = ply_slot(depth);
+        if (depth >= 2 && iteration_nodes[last - 1] > 0 && iteration_nodes[last] > 0) {
+            return static_cast<double>(iteration_nodes[last]) / iteration_nodes[last - 1];
+        }
+        return std::pow(static_cast<double>(nodes), 1.0 / depth);
+    }
+
+    // Add a helper's counters (per-iteration telemetry belongs to the main search)
+    void merge(const SearchStats& other) {
+        nodes += other.nodes;
+        cutoffs += other.cutoffs;
+        for (int i = 0; i < MAX_PLY; i++) {
+            nodes_at_ply[i] += other.nodes_at_ply[i];
+            cutoffs_at_ply[i] += other.cutoffs_at_ply[i];
+        }
+        tt_probes += other.tt_probes;
+        tt_hits += other.tt_hits;
+        tt_collisions += other.tt_collisions;
+        evaluations += other.evaluations;
+        pvs_researches += other.pvs_researches;
+        playouts += other.playouts;
+    }
+};
+
+#endif // SEARCH_STATS_H
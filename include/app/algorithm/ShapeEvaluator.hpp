@@ -0,0 +1,45 @@
+#ifndef SHAPE_EVALUATOR_H
+#define SHAPE_EVALUATOR_H
+
+#include <array>
+#include "Bitboard.hpp"
+#include "Evaluator.hpp"
+
+// Incremental shape evaluation.
+// Keeps the shape score of every line for both sides plus the bonus for
+// shapes of different directions crossing on a cell. A move only touches the
+// four lines through it, so update() rescores those lines and score() is a
+// plain read of the running total. Windows are scored by ShapeTable lookup.
+template <int COLUMNS, int ROWS>
+class ShapeEvaluator final : public Evaluator<COLUMNS, ROWS> {
+public:
+    using Board = Bitboard<COLUMNS, ROWS>;
+    static constexpr int ROW = ROWS;
+
+    // Rescore everything from the board
+    void reset(const Board& board) override;
+
+    // Call after a stone is placed on or removed from (x, y)
+    void update(const Board& board, int x, int y) override;
+
+    // Shape score of side 0 or 1
+    int score(int side) const override { return total[side]; }
+
+private:
+    int total[2] = {0, 0};
+    std::array<int, Board::LINES> line_score[2] = {};
+    // Best shape covering each cell, per side and direction
+    std::array<int, Board::CELLS> cover[2][Board::DIRECTIONS] = {};
+    // Cross-direction bonus currently counted for each cell
+    std::array<int, Board::CELLS> cell_bonus[2] = {};
+
+    void rescore_line(const Board& board, int line, int side);
+    int best_shape(uint32_t mine, uint32_t enemy, int start) const;
+    int cross_bonus(int side, int cell) const;
+};
+
+extern template class ShapeEvaluator<9, 9>;
+extern template class ShapeEvaluator<15, 15>;
+extern template class ShapeEvaluator<19, 19>;
+
+#endif // SHAPE_EVALUATOR_H
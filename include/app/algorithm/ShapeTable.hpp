@@ -0,0 +1,96 @@
+#ifndef SHAPE_TABLE_H
+#define SHAPE_TABLE_H
+
+#include <array>
+
+// Shape scores for pattern evaluation and the lookup table built from them.
+// A 6-cell line window is encoded in base 3 (cell i weighs 3^i; 0 = empty,
+// 1 = mine, 2 = enemy). SHAPE_TABLE maps every one of the 729 windows to the
+// best score of the shapes it matches: 5-cell shapes against the first five
+// cells, 6-cell shapes against all six. The table is generated at compile
+// time from SHAPES, so editing the list is all it takes to change scoring.
+namespace shape_table {
+
+struct Shape {
+    int score;
+    int length;
+    int cells[6];
+};
+
+constexpr Shape SHAPES[] = {
+    {50, 5, {0, 1, 1, 0, 0}},
+    {50, 5, {0, 0, 1, 1, 0}},
+    {200, 5, {1, 1, 0, 1, 0}},
+    {500, 5, {0, 0, 1, 1, 1}},
+    {500, 5, {1, 1, 1, 0, 0}},
+    {5000, 5, {0, 1, 1, 1, 0}},
+    {5000, 6, {0, 1, 0, 1, 1, 0}},
+    {5000, 6, {0, 1, 1, 0, 1, 0}},
+    {5000, 5, {1, 1, 1, 0, 1}},
+    {5000, 5, {1, 1, 0, 1, 1}},
+    {5000, 5, {1, 0, 1, 1, 1}},
+    {5000, 5, {1, 1, 1, 1, 0}},
+    {5000, 5, {0, 1, 1, 1, 1}},
+    {50000, 6, {0, 1, 1, 1, 1, 0}},
+    {99999999, 5, {1, 1, 1, 1, 1}}
+};
+
+constexpr int WINDOW = 6;
+constexpr int WINDOW_COUNT = 729; // 3^6
+
+// Base-3 value of a 6-bit mask, so a window index is BASE3[mine] + 2 * BASE3[enemy]
+constexpr std::array<int, 64> make_base3() {
+    std::array<int, 64> table{};
+    for (int mask = 0; mask < 64; mask++) {
+        int value = 0;
+        int weight = 1;
+        for (int i = 0; i < WINDOW; i++) {
+            if ((mask >> i) & 1) {
+                value += weight;
+            }
+            weight *= 3;
+        }
+        table[mask] = value;
+    }
+    return table;
+}
+
+constexpr std::array<int, WINDOW_COUNT> make_shape_table() {
+    std::array<int, WINDOW_COUNT> table{};
+    for (int index = 0; index < WINDOW_COUNT; index++) {
+        int pos[WINDOW] = {};
+        for (int i = 0, rest = index; i < WINDOW; i++, rest /= 3) {
+            pos[i] = rest % 3;
+        }
+
+        int best = 0;
+        for (const Shape& shape : SHAPES) {
+            bool matched = true;
+            for (int i = 0; i < shape.length; i++) {
+                matched = matched && pos[i] == shape.cells[i];
+            }
+            if (matched && shape.score > best) {
+                best = shape.score;
+            }
+        }
+        table[index] = best;
+    }
+    return table;
+}
+
+inline constexpr std::array<int, 64> BASE3 = make_base3();
+inline constexpr std::array<int, WINDOW_COUNT> SHAPE_TABLE = make_shape_table();
+
+// Best shape score of a window given as 6-bit masks of my and enemy stones
+constexpr int window_score(unsigned mine, unsigned enemy) {
+    return SHAPE_TABLE[BASE3[mine & 0x3F] + 2 * BASE3[enemy & 0x3F]];
+}
+
+static_assert(window_score(0x1F, 0) == 99999999, "five must score as a win");
+static_assert(window_score(0x1E, 0) == 50000, "open four");
+static_assert(window_score(0x1E, 0x20) == 5000, "four blocked on the sixth cell");
+static_assert(window_score(0, 0) == 0, "empty window");
+
+} // namespace shape_table
+
+#endif // SHAPE_TABLE_H
@@ -0,0 +1,81 @@
+#ifndef THREAT_SEARCH_H
+#define THREAT_SEARCH_H
+
+#include <utility>
+#include "Bitboard.hpp"
+#include "MoveList.hpp"
+
+// Threat-space search for forced wins.
+// VCF (victory by continuous fours) only tries moves that make a four, so
+// the defender always has exactly one reply. VCT also tries moves that make
+// an open three, and then every defence on the lines of that three has to be
+// refuted. The branching factor is tiny, so these searches go far deeper than
+// the main alpha-beta in the same time.
+//
+// Searches run on the caller's board and leave it as they found it.
+// Depths count attacker moves; the node limit bounds each find_* call, and
+// an optional stop check lets the caller bound it by time as well.
+template <int COLUMNS, int ROWS>
+class ThreatSearch {
+public:
+    using Board = Bitboard<COLUMNS, ROWS>;
+    static constexpr int ROW = ROWS;
+    static constexpr int CELLS = COLUMNS * ROWS;
+
+    ThreatSearch();
+
+    void set_node_limit(long long limit) { node_limit = limit; }
+
+    // check(context) is polled at the start of every find_* call and every
+    // few dozen nodes; once it returns true the search gives up as if out of
+    // nodes. nullptr (default) leaves only the node limit.
+    void set_stop_check(bool (*check)(void*), void* context) {
+        stop_check = check;
+        stop_context = context;
+    }
+
+    // Forced win for attacker (to move) by fours only
+    bool find_vcf(Board& board, int attacker, int max_depth, std::pair<int, int>& move);
+
+    // Forced win for attacker (to move) by fours and open threes
+    bool find_vct(Board& board, int attacker, int max_depth, std::pair<int, int>& move);
+
+    // Nodes searched by the last find_* call
+    long long nodes() const { return node_count; }
+
+    // The last find_* call gave up on the stop check
+    bool stopped() const { return stop; }
+
+private:
+    long long node_count;
+    long long node_limit;
+    bool (*stop_check)(void*);
+    void* stop_context;
+    bool stop;
+
+    // Count a node; true once the search has to give up
+    bool count_node();
+    bool given_up() const { return node_count > node_limit || stop; }
+    bool start_search();
+
+    bool vcf(Board& board, int attacker, int depth, int& move);
+    bool vct(Board& board, int attacker, int depth, int& move);
+
+    // Both search kinds: play a four, answer with the only block, recurse
+    bool try_four(Board& board, int attacker, int cell, int depth, bool with_threes);
+
+    // Cells completing five for side on the lines through (x, y)
+    int five_points_through(const Board& board, int side, int x, int y, int out[]) const;
+    // Side can make an open four (two five points on one line) through (x, y)
+    bool open_four_point_through(const Board& board, int side, int x, int y) const;
+    // Empty cells of windows holding `stones` stones of side and none of the other,
+    // in board order
+    void window_moves(const Board& board, int side, int stones, MoveList<CELLS>& out) const;
+    bool can_make_four(const Board& board, int side) const;
+};
+
+extern template class ThreatSearch<9, 9>;
+extern template class ThreatSearch<15, 15>;
+extern template class ThreatSearch<19, 19>;
+
+#endif // THREAT_SEARCH_H
@@ -0,0 +1,57 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+// Fixed-size hash table of search results keyed by Zobrist key.
+// The table holds a power-of-two number of 16-byte slots fitting in the
+// requested memory. A slot is replaced when it belongs to an older search or
+// the new result was searched at least as deep.
+//
+// Safe to share between search threads without locks: each slot stores its
+// packed data word and key ^ data, so a torn write fails the key check on
+// probe and reads as a collision.
+class TranspositionTable {
+public:
+    enum Bound : uint8_t { NONE = 0, EXACT = 1, LOWER = 2, UPPER = 3 };
+    enum ProbeResult { MISS, HIT, COLLISION };
+
+    struct Entry {
+        int32_t score;
+        int16_t move;   // cell index x * ROW + y, -1 if none
+        int8_t depth;
+        Bound bound;
+    };
+
+    explicit TranspositionTable(std::size_t megabytes = 16);
+
+    // Reallocate to fit in the given memory; drops every entry.
+    // Not thread-safe, call between searches only (as for clear / new_search).
+    void resize(std::size_t megabytes);
+    void clear();
+
+    // Start a new search: entries of earlier searches become replaceable
+    void new_search() { generation = (generation + 1) & 0x3F; }
+
+    ProbeResult probe(uint64_t key, Entry& out) const;
+    void store(uint64_t key, int depth, Bound bound, int score, int move);
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check; // key ^ data
+        std::atomic<uint64_t> data;
+    };
+
+    std::unique_ptr<Slot[]> table;
+    uint64_t mask = 0;
+    uint8_t generation = 0;
+
+    static uint64_t pack(const Entry& entry, uint8_t age);
+    static Entry unpack(uint64_t data);
+    static uint8_t age_of(uint64_t data) { return static_cast<uint8_t>(data >> 58); }
+};
+
+#endif // TRANSPOSITION_TABLE_H
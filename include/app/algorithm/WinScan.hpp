@@ -0,0 +1,44 @@
+#ifndef WIN_SCAN_H
+#define WIN_SCAN_H
+
+#include <cstdint>
+
+// Vectorised scans over the line masks of a Bitboard.
+// Each kernel tests several lines per instruction: AVX2 (8 lines) or SSE2
+// (4 lines) on x86, NEON (4 lines) on AArch64, with a portable scalar
+// fallback. The best kernel the CPU supports is picked on first use.
+namespace win_scan {
+
+enum class Impl { Scalar, SSE2, AVX2, NEON };
+
+// Fastest kernel this CPU runs
+Impl best_available();
+bool available(Impl impl);
+
+// Switch kernels, for benchmarks; not safe while a search is running
+void select(Impl impl);
+Impl selected();
+const char* name(Impl impl);
+
+// Any line with five consecutive bits set
+bool any_five(const uint32_t* lines, int count);
+
+// First line at or after `from` with a 5-cell window holding exactly four
+// stones of `mine` and nothing of `enemy` or `outside` (cells off the board),
+// i.e. a line where one more stone makes five. -1 if none.
+int first_four(const uint32_t* mine, const uint32_t* enemy, const uint32_t* outside, int count, int from = 0);
+
+// Windows of one line where one more stone makes five (bit = window start)
+inline uint32_t four_windows(uint32_t mine, uint32_t blocked) {
+    uint32_t a = mine, b = mine >> 1, c = mine >> 2, d = mine >> 3, e = mine >> 4;
+    uint32_t all4 = a & b & c & d;
+    uint32_t at_least4 = all4 | (e & ((a & b & (c | d)) | (c & d & (a | b))));
+    uint32_t five = all4 & e;
+    uint32_t blocked_window = blocked | (blocked >> 1) | (blocked >> 2) | (blocked >> 3) | (blocked >> 4);
+    // Windows must end inside the 32-bit line
+    return at_least4 & ~five & ~blocked_window & (~0u >> 4);
+}
+
+} // namespace win_scan
+
+#endif // WIN_SCAN_H
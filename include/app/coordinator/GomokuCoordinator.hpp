@@ -5,17 +5,24 @@
 #include "GomokuVision.hpp"
 #include "ArmController.hpp"
 #include <string>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <cstdint>
 
 /**
  * @brief Coordinates the interactions between Vision, AI, and a robotic arm.
  *
  * This class receives new piece detections, updates the game state,
  * checks for wins, and triggers AI decisions when appropriate.
+ * The AI searches in the background, so detection never waits for it;
+ * a piece detected during the search cancels it.
  */
 class GomokuCoordinator : public PieceEventCallback
 {
 public:
     GomokuCoordinator(GomokuAI &ai, int ai_player, ArmController *arm);
+    ~GomokuCoordinator();
 
     void onNewPieceDetected(int row, int col, const std::string &color) override;
 
@@ -24,5 +31,11 @@ private:
     const int ai_player;
     const int human_player;
     ArmController *armController;
+
+    std::mutex mutex;        // guards ai and generation
+    uint64_t generation = 0; // bumped by every detection; a search from an older one is stale
+    std::thread mover;       // waits for the AI's move and plays it
+
+    void playMove(std::future<std::pair<int, int>> move, uint64_t search_generation);
 };
 #endif
@@ -0,0 +1,121 @@
+#include "BatchAnalyzer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// Transposition table of each worker. Cold runs clear it before every
+// position, so it is kept small enough for that to cost little next to a
+// short search; set_tt_size() suits it to deeper searches.
+static const std::size_t WORKER_TT_MB = 1;
+
+BatchAnalyzer::BatchAnalyzer(std::pair<int, int> board_size, int search_depth, int threads, double attack_ratio)
+    : ROW(board_size.second), CELLS(static_cast<std::size_t>(board_size.first) * board_size.second),
+      warm(false), last_count(0), last_ms(0), stats{} {
+    if (threads <= 0) {
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    for (int i = 0; i < threads; i++) {
+        auto worker = std::make_unique<Worker>();
+        worker->engine = make_search_engine(board_size, search_depth, attack_ratio,
+                                            std::make_shared<TranspositionTable>(WORKER_TT_MB));
+        worker->player_pieces.reserve(CELLS);
+        worker->opponent_pieces.reserve(CELLS);
+        workers.push_back(std::move(worker));
+    }
+    pool.start(threads);
+}
+
+void BatchAnalyzer::evaluate(const uint8_t* boards, std::size_t count, Result* results) {
+    // Reject the whole batch before any search starts
+    for (std::size_t i = 0; i < count * CELLS; i++) {
+        if (boards[i] > 2) {
+            throw std::invalid_argument("[Error] Board " + std::to_string(i / CELLS) + " has cell value " +
+                                        std::to_string(boards[i]) + " (expected 0, 1 or 2)");
+        }
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    std::atomic<std::size_t> next(0);
+    int helpers = static_cast<int>(std::min<std::size_t>(workers.size(), count)) - 1;
+
+    // The calling thread is worker 0
+    auto task = [&](int index) { run_worker(*workers[index], boards, count, results, next); };
+    pool.run(helpers + 1, task);
+
+    stats = SearchStats{};
+#if GOMOKU_SEARCH_STATS
+    for (auto& worker : workers) {
+        stats.merge(worker->stats);
+        stats.threat_nodes += worker->stats.threat_nodes;
+    }
+#endif
+    stats.threads = 1 + std::max(0, helpers);
+    last_count = count;
+    last_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+}
+
+std::vector<BatchAnalyzer::Result> BatchAnalyzer::evaluate(const std::vector<uint8_t>& boards) {
+    if (boards.size() % CELLS != 0) {
+        throw std::invalid_argument("[Error] Batch of " + std::to_string(boards.size()) +
+                                    " cells is not a whole number of " + std::to_string(CELLS) + "-cell boards");
+    }
+    std::vector<Result> results(boards.size() / CELLS);
+    evaluate(boards.data(), results.size(), results.data());
+    return results;
+}
+
+void BatchAnalyzer::run_worker(Worker& worker, const uint8_t* boards, std::size_t count, Result* results,
+                               std::atomic<std::size_t>& next) {
+    worker.stats = SearchStats{};
+    for (std::size_t index = next++; index < count; index = next++) {
+        // Piece lists keep their capacity from position to position
+        const uint8_t* board = boards + index * CELLS;
+        worker.player_pieces.clear();
+        worker.opponent_pieces.clear();
+        for (std::size_t cell = 0; cell < CELLS; cell++) {
+            if (board[cell] == 1) {
+                worker.player_pieces.push_back({static_cast<int>(cell) / ROW, static_cast<int>(cell) % ROW});
+            } else if (board[cell] == 2) {
+                worker.opponent_pieces.push_back({static_cast<int>(cell) / ROW, static_cast<int>(cell) % ROW});
+            }
+        }
+
+        if (!warm) {
+            worker.engine->new_game();
+            if (auto table = worker.engine->get_tt()) {
+                table->clear();
+            }
+        }
+
+        std::pair<int, int> move = worker.engine->get_next_move(worker.player_pieces, worker.opponent_pieces);
+        const SearchStats& searched = worker.engine->get_search_stats();
+        results[index] = {move, searched.score, searched.depth};
+        SEARCH_STAT(worker.stats.merge(searched));
+        SEARCH_STAT(worker.stats.threat_nodes += searched.threat_nodes);
+    }
+}
+
+void BatchAnalyzer::set_time_limit(int milliseconds) {
+    for (auto& worker : workers) {
+        worker->engine->set_time_limit(milliseconds);
+    }
+}
+
+void BatchAnalyzer::set_threat_search(bool enabled) {
+    for (auto& worker : workers) {
+        worker->engine->set_threat_search(enabled);
+    }
+}
+
+void BatchAnalyzer::set_tt_size(std::size_t megabytes) {
+    for (auto& worker : workers) {
+        worker->engine->set_tt_size(megabytes);
+    }
+}
+
+double BatchAnalyzer::positions_per_second() const {
+    return last_ms > 0 ? last_count * 1000.0 / last_ms : 0.0;
+}
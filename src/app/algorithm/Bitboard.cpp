@@ -0,0 +1,94 @@
+#include "Bitboard.hpp"
+#include "WinScan.hpp"
+#include <bit>
+
+template <int COLUMNS, int ROWS>
+Bitboard<COLUMNS, ROWS>::Bitboard() {
+    clear();
+}
+
+template <int COLUMNS, int ROWS>
+void Bitboard<COLUMNS, ROWS>::clear() {
+    lines[0].fill(0);
+    lines[1].fill(0);
+    key = 0;
+}
+
+template <int COLUMNS, int ROWS>
+void Bitboard<COLUMNS, ROWS>::place(int x, int y, int side) {
+    for (int dir = 0; dir < DIRECTIONS; dir++) {
+        lines[side][line_of(dir, x, y)] |= 1u << bit_of(dir, x, y);
+    }
+    key ^= ZOBRIST[side][x * ROW + y];
+}
+
+template <int COLUMNS, int ROWS>
+void Bitboard<COLUMNS, ROWS>::remove(int x, int y, int side) {
+    for (int dir = 0; dir < DIRECTIONS; dir++) {
+        lines[side][line_of(dir, x, y)] &= ~(1u << bit_of(dir, x, y));
+    }
+    key ^= ZOBRIST[side][x * ROW + y];
+}
+
+template <int COLUMNS, int ROWS>
+bool Bitboard<COLUMNS, ROWS>::has_stone(int x, int y, int side) const {
+    return in_bounds(x, y) && ((lines[side][LINE_BASE[ROW_LINE] + x] >> y) & 1u);
+}
+
+template <int COLUMNS, int ROWS>
+bool Bitboard<COLUMNS, ROWS>::is_empty(int x, int y) const {
+    int row = LINE_BASE[ROW_LINE] + x;
+    return in_bounds(x, y) && !(((lines[0][row] | lines[1][row]) >> y) & 1u);
+}
+
+template <int COLUMNS, int ROWS>
+bool Bitboard<COLUMNS, ROWS>::has_neighbor(int x, int y) const {
+    // Bits y-1..y+1 of the three rows around x, without the cell itself
+    uint32_t window = (y > 0 ? 7u << (y - 1) : 3u);
+    for (int i = x - 1; i <= x + 1; i++) {
+        if (i < 0 || i >= COLUMN) {
+            continue;
+        }
+        uint32_t mask = (i == x) ? window & ~(1u << y) : window;
+        int row = LINE_BASE[ROW_LINE] + i;
+        if ((lines[0][row] | lines[1][row]) & mask) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <int COLUMNS, int ROWS>
+bool Bitboard<COLUMNS, ROWS>::has_five(int side) const {
+    return win_scan::any_five(lines[side].data(), LINES);
+}
+
+template <int COLUMNS, int ROWS>
+bool Bitboard<COLUMNS, ROWS>::makes_five(int x, int y, int side) const {
+    for (int dir = 0; dir < DIRECTIONS; dir++) {
+        uint32_t m = lines[side][line_of(dir, x, y)] | (1u << bit_of(dir, x, y));
+        if (m & (m >> 1) & (m >> 2) & (m >> 3) & (m >> 4)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <int COLUMNS, int ROWS>
+int Bitboard<COLUMNS, ROWS>::five_point(int side) const {
+    // Vector scan for the line, then pick the window inside it
+    int line = win_scan::first_four(lines[side].data(), lines[1 - side].data(), TABLE.outside.data(), LINES);
+    if (line < 0) {
+        return -1;
+    }
+
+    uint32_t mine = lines[side][line];
+    uint32_t windows = win_scan::four_windows(mine, lines[1 - side][line] | TABLE.outside[line]);
+    uint32_t window = 0x1Fu << std::countr_zero(windows);
+    auto [x, y] = cell_at(line, std::countr_zero(window & ~mine));
+    return x * ROW + y;
+}
+
+template class Bitboard<9, 9>;
+template class Bitboard<15, 15>;
+template class Bitboard<19, 19>;
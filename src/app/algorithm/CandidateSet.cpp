@@ -0,0 +1,80 @@
+#include "CandidateSet.hpp"
+#include <algorithm>
+
+template <int COLUMNS, int ROWS>
+CandidateSet<COLUMNS, ROWS>::CandidateSet(int radius) : RADIUS(radius) {
+    clear();
+}
+
+template <int COLUMNS, int ROWS>
+void CandidateSet<COLUMNS, ROWS>::clear() {
+    cells.clear();
+    position.fill(-1);
+    near_count.fill(0);
+    occupied.fill(0);
+}
+
+template <int COLUMNS, int ROWS>
+void CandidateSet<COLUMNS, ROWS>::insert(int cell) {
+    if (position[cell] < 0) {
+        position[cell] = cells.size();
+        cells.push_back(cell);
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void CandidateSet<COLUMNS, ROWS>::erase(int cell) {
+    int index = position[cell];
+    if (index >= 0) {
+        int last = cells.back();
+        cells[index] = last;
+        position[last] = index;
+        cells.pop_back();
+        position[cell] = -1;
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void CandidateSet<COLUMNS, ROWS>::place(int x, int y) {
+    int cell = x * ROW + y;
+    occupied[cell] = 1;
+    erase(cell);
+
+    for (int i = std::max(0, x - RADIUS); i <= std::min(COLUMN - 1, x + RADIUS); i++) {
+        for (int j = std::max(0, y - RADIUS); j <= std::min(ROW - 1, y + RADIUS); j++) {
+            int near = i * ROW + j;
+            if (near == cell) {
+                continue;
+            }
+            if (++near_count[near] == 1 && !occupied[near]) {
+                insert(near);
+            }
+        }
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void CandidateSet<COLUMNS, ROWS>::remove(int x, int y) {
+    int cell = x * ROW + y;
+    occupied[cell] = 0;
+
+    for (int i = std::max(0, x - RADIUS); i <= std::min(COLUMN - 1, x + RADIUS); i++) {
+        for (int j = std::max(0, y - RADIUS); j <= std::min(ROW - 1, y + RADIUS); j++) {
+            int near = i * ROW + j;
+            if (near == cell) {
+                continue;
+            }
+            if (--near_count[near] == 0) {
+                erase(near);
+            }
+        }
+    }
+
+    if (near_count[cell] > 0) {
+        insert(cell);
+    }
+}
+
+template class CandidateSet<9, 9>;
+template class CandidateSet<15, 15>;
+template class CandidateSet<19, 19>;
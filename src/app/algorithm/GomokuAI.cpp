@@ -1,47 +1,262 @@
 #include "GomokuAI.hpp"
+#include "PatternWeights.hpp"
 
-GomokuAI::GomokuAI(int size)
-    : size(size), board(size, std::vector<int>(size, 0)),
-      minimax({size, size}, 2 /* search depth */, 1.0 /* attack-defense ratio */) {}
+// Human replies searched ahead while pondering
+static const int PONDER_REPLIES = 6;
 
-void GomokuAI::updateBoard(int row, int col, int player)
+// Search depth, or playouts for MCTS, when there is no time limit
+static const int SEARCH_DEPTH = 2;
+static const int MCTS_PLAYOUTS = 20000;
+
+// A minimax engine searches with table when given; MCTS keeps its own tree
+static std::unique_ptr<SearchEngine> makeEngine(int size, EngineType engine,
+                                                std::shared_ptr<TranspositionTable> table = nullptr)
 {
-    board[row][col] = player;
+    if (engine == EngineType::Mcts)
+        return make_mcts_engine({size, size}, MCTS_PLAYOUTS, 1.0 /* attack-defense ratio */);
+    return make_search_engine({size, size}, SEARCH_DEPTH, 1.0 /* attack-defense ratio */, std::move(table));
 }
 
-bool GomokuAI::checkWin(int player)
+GomokuAI::GomokuAI(int size, int move_time_ms, int threads, bool ponder, EngineType engine)
+    : size(size), board(size * size, 0), winner(0), minimax(makeEngine(size, engine)),
+      search_stop(false), search_interrupt(false), searching(false),
+      ponder(ponder), ponderer(makeEngine(size, engine, minimax->get_tt())), ponder_stop(false), ponder_counts{0, 0, 0}
 {
-    std::vector<std::pair<int, int>> pieces;
-    for (int i = 0; i < size; ++i)
-        for (int j = 0; j < size; ++j)
-            if (board[i][j] == player)
-                pieces.emplace_back(i, j);
-    return minimax.check_win(pieces);
+    for (auto &list : pieces)
+        list.reserve(size * size);
+
+    minimax->set_time_limit(move_time_ms);
+    minimax->set_threads(threads);
+    minimax->set_stop_signal(&search_stop);
+    minimax->set_interrupt_signal(&search_interrupt);
+    minimax->new_game();
+
+    // Same search as getBestMove(), warming the same table
+    ponderer->set_time_limit(move_time_ms);
+    ponderer->set_threads(threads);
+    ponderer->set_stop_signal(&ponder_stop);
 }
 
-int GomokuAI::countPieces(int player) const
+GomokuAI::~GomokuAI()
+{
+    cancelSearch();
+    stopPondering();
+}
+
+// Stones are only ever added; a cell that is already taken is left as it is
+void GomokuAI::updateBoard(int row, int col, int player)
+{
+    int &cell = board[row * size + col];
+    if (cell != 0 || (player != 1 && player != 2))
+        return;
+    cancelSearch();
+    cell = player;
+    pieces[player].emplace_back(row, col);
+    minimax->make_move({row, col}, player == 2);
+    if (winner != 0)
+        return;
+
+    // A new five has to run through the new stone
+    static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    for (const auto &d : directions)
+    {
+        int length = 1 + countLine(row, col, d[0], d[1], player) + countLine(row, col, -d[0], -d[1], player);
+        if (length >= 5)
+        {
+            winner = player;
+            return;
+        }
+    }
+}
+
+// Stones of player in a row from (row, col), not counting (row, col) itself
+int GomokuAI::countLine(int row, int col, int d_row, int d_col, int player) const
 {
     int count = 0;
-    for (const auto &row : board)
-        for (int cell : row)
-            if (cell == player)
-                count++;
+    for (int r = row + d_row, c = col + d_col;
+         r >= 0 && r < size && c >= 0 && c < size && board[r * size + c] == player && count < 4;
+         r += d_row, c += d_col)
+        count++;
     return count;
 }
 
+bool GomokuAI::checkWin(int player) const
+{
+    return winner == player;
+}
+
+bool GomokuAI::isGameOver() const
+{
+    return winner != 0;
+}
+
+int GomokuAI::countPieces(int player) const
+{
+    return (player == 1 || player == 2) ? static_cast<int>(pieces[player].size()) : 0;
+}
+
+bool GomokuAI::loadOpeningBook(const std::string &path)
+{
+    if (!book.open(path))
+        return false;
+    if (book.board_size() != size)
+    {
+        book.close();
+        return false;
+    }
+    return true;
+}
+
+bool GomokuAI::loadEvaluator(const std::string &path)
+{
+    auto weights = std::make_shared<PatternWeights>();
+    if (!weights->load(path))
+        return false;
+    cancelSearch();
+    stopPondering();
+    minimax->set_evaluator(weights);
+    ponderer->set_evaluator(weights);
+    return true;
+}
+
+void GomokuAI::setBeam(int width, int root_width)
+{
+    cancelSearch();
+    stopPondering();
+    minimax->set_beam(width, root_width);
+    ponderer->set_beam(width, root_width);
+}
+
+void GomokuAI::setNodeLimit(uint64_t nodes)
+{
+    cancelSearch();
+    stopPondering();
+    minimax->set_node_limit(nodes);
+    ponderer->set_node_limit(nodes);
+}
+
 std::pair<int, int> GomokuAI::getBestMove()
 {
-    std::vector<std::pair<int, int>> ai_pieces;
-    std::vector<std::pair<int, int>> human_pieces;
+    cancelSearch();
+    stopPondering();
 
-    for (int i = 0; i < size; ++i)
-        for (int j = 0; j < size; ++j)
+    std::pair<int, int> move;
+    if (findReadyMove(move))
+        return move;
+
+    search_stop = false;
+    search_interrupt = false;
+    return minimax->get_next_move();
+}
+
+std::future<std::pair<int, int>> GomokuAI::getBestMoveAsync()
+{
+    cancelSearch();
+    stopPondering();
+
+    std::promise<std::pair<int, int>> promise;
+    std::future<std::pair<int, int>> result = promise.get_future();
+    std::pair<int, int> move;
+    if (findReadyMove(move))
+    {
+        promise.set_value(move);
+        return result;
+    }
+
+    search_stop = false;
+    search_interrupt = false;
+    searching = true;
+    search_thread = std::thread(
+        [this, promise = std::move(promise)]() mutable
         {
-            if (board[i][j] == 2)
-                ai_pieces.emplace_back(i, j);
-            else if (board[i][j] == 1)
-                human_pieces.emplace_back(i, j);
-        }
+            std::pair<int, int> best = minimax->get_next_move();
+            if (search_stop)
+                best = {-1, -1};
+            searching = false;
+            promise.set_value(best);
+        });
+    return result;
+}
+
+void GomokuAI::interruptSearch()
+{
+    search_interrupt = true;
+}
+
+void GomokuAI::cancelSearch()
+{
+    if (!search_thread.joinable())
+        return;
+    search_stop = true;
+    search_thread.join();
+}
+
+bool GomokuAI::isSearching() const
+{
+    return searching;
+}
+
+// Book moves were searched far deeper offline; a ponder hit was searched while the human thought
+bool GomokuAI::findReadyMove(std::pair<int, int> &move) const
+{
+    if (book.probe(pieces[2], pieces[1], move) && board[move.first * size + move.second] == 0)
+        return true;
+    return findPonderHit(move);
+}
+
+void GomokuAI::startPondering()
+{
+    if (!ponder)
+        return;
+    stopPondering();
+
+    for (int player = 1; player <= 2; player++)
+        ponder_counts[player] = pieces[player].size();
+    ponder_replies.clear();
+    ponder_stop = false;
+
+    ponder_thread = std::thread(&GomokuAI::ponderLoop, this, pieces[2], pieces[1]);
+}
+
+void GomokuAI::stopPondering()
+{
+    if (!ponder_thread.joinable())
+        return;
+    ponder_stop = true;
+    ponder_thread.join();
+}
+
+// Background thread: answer the likely human replies one by one until stopped
+void GomokuAI::ponderLoop(std::vector<std::pair<int, int>> ai_pieces, std::vector<std::pair<int, int>> human_pieces)
+{
+    auto replies = ponderer->likely_moves(human_pieces, ai_pieces, PONDER_REPLIES);
+
+    for (const auto &reply : replies)
+    {
+        if (ponder_stop)
+            return;
+
+        human_pieces.push_back(reply);
+        auto answer = ponderer->get_next_move(ai_pieces, human_pieces);
+        human_pieces.pop_back();
+
+        // An interrupted search has no reliable move; what it found stays in the table
+        if (ponder_stop)
+            return;
+        ponder_replies[reply] = answer;
+    }
+}
+
+// The board must be the pondered position plus exactly one human stone
+bool GomokuAI::findPonderHit(std::pair<int, int> &move) const
+{
+    if (ponder_replies.empty() || pieces[2].size() != ponder_counts[2] ||
+        pieces[1].size() != ponder_counts[1] + 1)
+        return false;
 
-    return minimax.get_next_move(ai_pieces, human_pieces);
+    auto it = ponder_replies.find(pieces[1].back());
+    if (it == ponder_replies.end())
+        return false;
+    move = it->second;
+    return true;
 }
@@ -0,0 +1,67 @@
+#include "HelperThreads.hpp"
+
+HelperThreads::~HelperThreads() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        quit = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void HelperThreads::start(int count) {
+    // Pool thread i runs task(i); index 0 is the caller
+    while (static_cast<int>(threads.size()) < count - 1) {
+        int index = static_cast<int>(threads.size()) + 1;
+        threads.emplace_back([this, index]() { thread_main(index); });
+    }
+}
+
+void HelperThreads::dispatch(int count, void* task_context, void (*task_call)(void*, int)) {
+    start(count);
+
+    int started = count > 1 ? count - 1 : 0;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        round++;
+        helpers = started;
+        running = started;
+        context = task_context;
+        call = task_call;
+    }
+    if (started > 0) {
+        wake.notify_all();
+    }
+
+    task_call(task_context, 0);
+
+    std::unique_lock<std::mutex> guard(lock);
+    done.wait(guard, [this]() { return running == 0; });
+}
+
+void HelperThreads::thread_main(int index) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        wake.wait(guard, [&]() { return quit || round != seen; });
+        if (quit) {
+            return;
+        }
+        seen = round;
+        if (index > helpers) {
+            continue;
+        }
+
+        void* task_context = context;
+        void (*task_call)(void*, int) = call;
+        guard.unlock();
+        task_call(task_context, index);
+        guard.lock();
+
+        if (--running == 0) {
+            done.notify_one();
+        }
+    }
+}
@@ -0,0 +1,194 @@
+#include "LinearEvaluator.hpp"
+#include <algorithm>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Sum of count int16 weights. SSE2 and NEON are part of the x86-64 and AArch64
+// baselines, so unlike the win scan kernels there is nothing to pick at startup.
+static int sum_weights(const int16_t* values, int count) {
+    int i = 0;
+    int sum = 0;
+#if defined(__SSE2__)
+    // madd by ones widens adjacent pairs to int32 before they can overflow
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(v, ones));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    sum = _mm_cvtsi128_si32(acc);
+#elif defined(__ARM_NEON)
+    int32x4_t acc = vdupq_n_s32(0);
+    for (; i + 8 <= count; i += 8) {
+        acc = vpadalq_s16(acc, vld1q_s16(values + i));
+    }
+    sum = vaddvq_s32(acc);
+#endif
+    for (; i < count; i++) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+template <int COLUMNS, int ROWS>
+LinearEvaluator<COLUMNS, ROWS>::LinearEvaluator(std::shared_ptr<const PatternWeights> pattern_weights)
+    : weights(std::move(pattern_weights)) {
+    // Cell weights looked up by packed levels rather than pattern
+    for (int packed = 0; packed < PACKED_LEVELS; packed++) {
+        uint8_t cell_levels[Board::DIRECTIONS];
+        for (int dir = 0; dir < Board::DIRECTIONS; dir++) {
+            cell_levels[dir] = static_cast<uint8_t>((packed >> (LEVEL_BITS * dir)) & LEVEL_MASK);
+        }
+        packed_weight[packed] = weights->cell(PatternWeights::cell_pattern(cell_levels));
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void LinearEvaluator<COLUMNS, ROWS>::reset(const Board& board) {
+    for (int side = 0; side < 2; side++) {
+        total[side] = 0;
+        fives[side] = 0;
+        line_score[side].fill(0);
+        line_five[side].fill(false);
+        cell_levels[side].fill(0);
+        cell_score[side].fill(0);
+    }
+
+    for (int line = 0; line < board.line_count(); line++) {
+        rescore_line(board, line, 0);
+        rescore_line(board, line, 1);
+    }
+    for (int x = 0; x < COLUMNS; x++) {
+        for (int y = 0; y < ROWS; y++) {
+            if (board.is_empty(x, y)) {
+                rescore_cell(board, x, y);
+            }
+        }
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void LinearEvaluator<COLUMNS, ROWS>::update(const Board& board, int x, int y) {
+    for (int dir = 0; dir < Board::DIRECTIONS; dir++) {
+        int line = board.line_of(dir, x, y);
+        rescore_line(board, line, 0);
+        rescore_line(board, line, 1);
+    }
+
+    // Only the levels along the four lines change, for the empty cells up to 4 away
+    for (int dir = 0; dir < Board::DIRECTIONS; dir++) {
+        int line = board.line_of(dir, x, y);
+        int bit = board.bit_of(dir, x, y);
+        auto [lo, hi] = board.line_span(line);
+        uint32_t stones = board.line_mask(line, 0) | board.line_mask(line, 1);
+        int shift = LEVEL_BITS * dir;
+
+        for (int side = 0; side < 2; side++) {
+            // Four bits up, as in cell_level()
+            uint64_t mine = static_cast<uint64_t>(board.line_mask(line, side)) << 4;
+            uint64_t blocked = static_cast<uint64_t>(board.line_mask(line, 1 - side) | board.outside_data()[line]) << 4 | 0xF;
+            for (int b = std::max(lo, bit - 4); b <= std::min(hi, bit + 4); b++) {
+                if (b == bit || ((stones >> b) & 1)) {
+                    continue;
+                }
+                auto [cx, cy] = board.cell_at(line, b);
+                int cell = cx * ROWS + cy;
+                int level = PatternWeights::level(static_cast<uint32_t>(mine >> b) & 0x1FF,
+                                                  static_cast<uint32_t>(blocked >> b) & 0x1FF);
+                int packed = (cell_levels[side][cell] & ~(LEVEL_MASK << shift)) | (level << shift);
+                if (packed != cell_levels[side][cell]) {
+                    cell_levels[side][cell] = static_cast<uint16_t>(packed);
+                    set_cell_score(side, cell, packed_weight[packed]);
+                }
+            }
+        }
+    }
+
+    // An occupied cell scores nothing
+    if (board.is_empty(x, y)) {
+        rescore_cell(board, x, y);
+    } else {
+        set_cell_score(0, x * ROWS + y, 0);
+        set_cell_score(1, x * ROWS + y, 0);
+    }
+}
+
+template <int COLUMNS, int ROWS>
+int LinearEvaluator<COLUMNS, ROWS>::line_patterns(const Board& board, int line, int side, int* patterns) {
+    auto [lo, hi] = board.line_span(line);
+    if (hi - lo + 1 < 5) {
+        return 0;
+    }
+
+    // One bit up, so the cell before bit 0 can be read; it is off the board
+    uint64_t mine = static_cast<uint64_t>(board.line_mask(line, side)) << 1;
+    uint64_t blocked = static_cast<uint64_t>(board.line_mask(line, 1 - side) | board.outside_data()[line]) << 1 | 1;
+
+    int count = 0;
+    for (int start = lo; start <= hi - 3; start++) {
+        patterns[count++] = PatternWeights::line_pattern(mine, blocked, start);
+    }
+    return count;
+}
+
+template <int COLUMNS, int ROWS>
+void LinearEvaluator<COLUMNS, ROWS>::rescore_line(const Board& board, int line, int side) {
+    int patterns[MAX_WINDOWS];
+    alignas(16) int16_t values[MAX_WINDOWS];
+    int count = line_patterns(board, line, side, patterns);
+    for (int i = 0; i < count; i++) {
+        values[i] = weights->line(patterns[i]);
+    }
+
+    int score = sum_weights(values, count);
+    total[side] += score - line_score[side][line];
+    line_score[side][line] = score;
+
+    uint32_t m = board.line_mask(line, side);
+    bool five = (m & (m >> 1) & (m >> 2) & (m >> 3) & (m >> 4)) != 0;
+    fives[side] += static_cast<int>(five) - static_cast<int>(line_five[side][line]);
+    line_five[side][line] = five;
+}
+
+template <int COLUMNS, int ROWS>
+int LinearEvaluator<COLUMNS, ROWS>::cell_level(const Board& board, int dir, int x, int y, int side) {
+    // Four bits up, so the 4 cells before bit 0 can be read; they are off the board
+    int line = board.line_of(dir, x, y);
+    int bit = board.bit_of(dir, x, y);
+    uint64_t mine = static_cast<uint64_t>(board.line_mask(line, side)) << 4;
+    uint64_t blocked = static_cast<uint64_t>(board.line_mask(line, 1 - side) | board.outside_data()[line]) << 4 | 0xF;
+    return PatternWeights::level(static_cast<uint32_t>(mine >> bit) & 0x1FF, static_cast<uint32_t>(blocked >> bit) & 0x1FF);
+}
+
+template <int COLUMNS, int ROWS>
+int LinearEvaluator<COLUMNS, ROWS>::cell_pattern(const Board& board, int x, int y, int side) {
+    uint8_t cell_levels[Board::DIRECTIONS];
+    for (int dir = 0; dir < Board::DIRECTIONS; dir++) {
+        cell_levels[dir] = static_cast<uint8_t>(cell_level(board, dir, x, y, side));
+    }
+    return PatternWeights::cell_pattern(cell_levels);
+}
+
+template <int COLUMNS, int ROWS>
+void LinearEvaluator<COLUMNS, ROWS>::rescore_cell(const Board& board, int x, int y) {
+    int cell = x * ROWS + y;
+    for (int side = 0; side < 2; side++) {
+        int packed = 0;
+        for (int dir = 0; dir < Board::DIRECTIONS; dir++) {
+            packed |= cell_level(board, dir, x, y, side) << (LEVEL_BITS * dir);
+        }
+        cell_levels[side][cell] = static_cast<uint16_t>(packed);
+        set_cell_score(side, cell, packed_weight[packed]);
+    }
+}
+
+template class LinearEvaluator<9, 9>;
+template class LinearEvaluator<15, 15>;
+template class LinearEvaluator<19, 19>;
@@ -0,0 +1,633 @@
+#include "MctsAlgorithm.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Threat-space search limits, as in MinimaxAlgorithm
+static const int VCF_DEPTH = 12;
+static const int VCT_DEPTH = 4;
+static const long long THREAT_NODE_LIMIT = 20000;
+
+// Tree shape: children kept per expansion unless set_beam() says otherwise,
+// the most a node can hold, visits before a leaf is expanded
+static const int DEFAULT_CHILDREN = 32;
+static const int MAX_CHILDREN = 255;
+static const uint32_t EXPAND_VISITS = 2;
+
+// PUCT exploration weight, value of an unvisited child, and the softmax
+// temperature turning shape scores into priors (about half an open three)
+static const double EXPLORATION = 1.5;
+static const double FIRST_PLAY_VALUE = 0.5;
+static const double PRIOR_TEMPERATURE = 2500.0;
+
+// Both pools together, unless set_tt_size() says otherwise
+static const std::size_t DEFAULT_TREE_MB = 32;
+
+// Constructor implementation
+template <int COLUMNS, int ROWS>
+MctsAlgorithm<COLUMNS, ROWS>::MctsAlgorithm(int playouts, double attack_ratio)
+    : playouts_left(0), candidates(1) {
+    // Initialize basic parameters
+    PLAYOUTS = std::max(1, playouts);
+    ratio = attack_ratio;
+    radius = 1;
+
+    // Fixed playout count, single-threaded unless asked otherwise
+    time_limit_ms = 0;
+    set_threads(1);
+    stop_signal = nullptr;
+    interrupt_signal = nullptr;
+    node_limit = 0;
+    stats = SearchStats{};
+    max_depth = 0;
+
+    // A game never holds more stones than cells
+    player_pieces.reserve(CELLS);
+    opponent_pieces.reserve(CELLS);
+
+    // Forced wins are checked before searching
+    use_threat_search = true;
+
+    // Expansion widths
+    children = DEFAULT_CHILDREN;
+    root_children = DEFAULT_CHILDREN;
+
+    // Node pools and an empty tree
+    active = 0;
+    root = 0;
+    root_side = 0;
+    set_tt_size(DEFAULT_TREE_MB);
+    new_game();
+}
+
+template <int COLUMNS, int ROWS>
+std::pair<int, int> MctsAlgorithm<COLUMNS, ROWS>::get_next_move(const Pieces& player_pieces_input,
+                                                                const Pieces& opponent_pieces_input) {
+    load_position(player_pieces_input, opponent_pieces_input);
+    return get_next_move();
+}
+
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::new_game() {
+    player_pieces.clear();
+    opponent_pieces.clear();
+    all_pieces.clear();
+    board.clear();
+    candidates.clear();
+    evaluator.reset(board);
+    reset_tree(0);
+}
+
+// The subtree of the move becomes the tree if the root had been expanded for
+// this side; otherwise the search starts over from the new position
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::make_move(std::pair<int, int> pos, bool is_ai) {
+    int side = is_ai ? 0 : 1;
+    int cell = pos.first * ROW + pos.second;
+    (is_ai ? player_pieces : opponent_pieces).push_back(pos);
+    all_pieces.push_back(cell);
+    board.place(pos.first, pos.second, side);
+    candidates.place(pos.first, pos.second);
+    evaluator.update(board, pos.first, pos.second);
+
+    Node* pool = pools[active].get();
+    const Node& node = pool[root];
+    if (root_side == side && node.state.load(std::memory_order_acquire) == EXPANDED) {
+        for (int k = 0; k < node.child_count; k++) {
+            if (pool[node.first_child + k].move == cell) {
+                root = node.first_child + k;
+                root_side = 1 - side;
+                return;
+            }
+        }
+    }
+    reset_tree(1 - side);
+}
+
+template <int COLUMNS, int ROWS>
+std::pair<int, int> MctsAlgorithm<COLUMNS, ROWS>::get_next_move() {
+    SEARCH_STAT(auto started = std::chrono::steady_clock::now());
+    stats = SearchStats{};
+    max_depth = 0;
+
+    std::pair<int, int> move;
+    if (all_pieces.empty()) {
+        // No stone to grow candidates from: open in the centre
+        move = {COLUMN / 2, ROW / 2};
+    } else if (candidates.empty()) {
+        // Full board: there is no move to play
+        move = {-1, -1};
+    } else if (use_threat_search && solve_threats(move)) {
+        // A forced win is played straight away
+        stats.score = 1000;
+    } else {
+        if (root_side != 0) {
+            reset_tree(0);
+        }
+        compact_tree();
+        search();
+
+        // The most visited move; the value breaks ties
+        const Node* pool = pools[active].get();
+        const Node& node = pool[root];
+        uint32_t best = NO_NODE;
+        for (int k = 0; k < node.child_count; k++) {
+            uint32_t child = node.first_child + k;
+            if (best == NO_NODE || pool[child].visits > pool[best].visits ||
+                (pool[child].visits == pool[best].visits && pool[child].value > pool[best].value)) {
+                best = child;
+            }
+        }
+        int cell = *candidates.begin(); // not empty, checked above
+        if (best != NO_NODE) {
+            cell = pool[best].move;
+            uint32_t visits = pool[best].visits;
+            stats.score = visits > 0 ? static_cast<int>(pool[best].value * 500ull / visits) : 500;
+        }
+        move = {cell / ROW, cell % ROW};
+    }
+
+    stats.depth = max_depth;
+    stats.threads = thread_count;
+    SEARCH_STAT(stats.elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count());
+    return move;
+}
+
+// Our own forced win only; defence is left to the playouts
+template <int COLUMNS, int ROWS>
+bool MctsAlgorithm<COLUMNS, ROWS>::solve_threats(std::pair<int, int>& move) {
+    threats.set_node_limit(THREAT_NODE_LIMIT);
+    bool found = threats.find_vcf(board, 0, VCF_DEPTH, move);
+    SEARCH_STAT(stats.threat_nodes += threats.nodes());
+    if (!found) {
+        found = threats.find_vct(board, 0, VCT_DEPTH, move);
+        SEARCH_STAT(stats.threat_nodes += threats.nodes());
+    }
+    return found;
+}
+
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::load_position(const Pieces& player_pieces_input,
+                                                 const Pieces& opponent_pieces_input) {
+    player_pieces.assign(player_pieces_input.begin(), player_pieces_input.end());
+    opponent_pieces.assign(opponent_pieces_input.begin(), opponent_pieces_input.end());
+
+    all_pieces.clear();
+    board.clear();
+    candidates.clear();
+    for (const auto& pt : player_pieces) {
+        all_pieces.push_back(pt.first * ROW + pt.second);
+        board.place(pt.first, pt.second, 0);
+        candidates.place(pt.first, pt.second);
+    }
+    for (const auto& pt : opponent_pieces) {
+        all_pieces.push_back(pt.first * ROW + pt.second);
+        board.place(pt.first, pt.second, 1);
+        candidates.place(pt.first, pt.second);
+    }
+    evaluator.reset(board);
+
+    // Nothing is known about how the position was reached
+    reset_tree(0);
+}
+
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::reset_tree(int side_to_move) {
+    root = 0;
+    root_side = side_to_move;
+    pool_used.store(1, std::memory_order_relaxed);
+    init_node(pools[active][root], all_pieces.empty() ? -1 : all_pieces.back(), 1.0f, false);
+}
+
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::init_node(Node& node, int move, float prior, bool wins) {
+    node.visits.store(0, std::memory_order_relaxed);
+    node.value.store(0, std::memory_order_relaxed);
+    node.first_child = NO_NODE;
+    node.prior = prior;
+    node.move = static_cast<int16_t>(move);
+    node.child_count = 0;
+    node.wins = wins;
+    node.state.store(LEAF, std::memory_order_relaxed);
+}
+
+// Copy the tree under root into the spare pool, breadth first, and swap pools.
+// Children stay contiguous, and the new pool doubles as the queue.
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::compact_tree() {
+    if (root == 0) {
+        return;
+    }
+    const Node* from = pools[active].get();
+    Node* to = pools[1 - active].get();
+
+    auto copy = [](const Node& source, Node& target) {
+        target.visits.store(source.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        target.value.store(source.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        target.first_child = source.first_child;
+        target.prior = source.prior;
+        target.move = source.move;
+        target.child_count = source.child_count;
+        target.wins = source.wins;
+        uint8_t state = source.state.load(std::memory_order_relaxed);
+        target.state.store(state == EXPANDED ? EXPANDED : LEAF, std::memory_order_relaxed);
+    };
+
+    copy(from[root], to[0]);
+    uint32_t used = 1;
+    for (uint32_t i = 0; i < used; i++) {
+        Node& node = to[i];
+        if (node.state.load(std::memory_order_relaxed) != EXPANDED) {
+            node.first_child = NO_NODE;
+            node.child_count = 0;
+            continue;
+        }
+        for (int k = 0; k < node.child_count; k++) {
+            copy(from[node.first_child + k], to[used + k]);
+        }
+        node.first_child = used;
+        used += node.child_count;
+    }
+
+    active = 1 - active;
+    root = 0;
+    pool_used.store(used, std::memory_order_relaxed);
+}
+
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::search() {
+    // Every worker starts from the root position
+    for (int i = 0; i < thread_count; i++) {
+        Worker& worker = *workers[i];
+        worker.board = board;
+        worker.candidates = candidates;
+        worker.evaluator = evaluator;
+        worker.rng.seed(0x9E3779B97F4A7C15ull * (i + 1) + all_pieces.size());
+        worker.stats = SearchStats{};
+        worker.max_depth = 0;
+    }
+
+    // The node limit caps the playout count, or the playouts in the time limit
+    int limit = static_cast<int>(std::min<uint64_t>(node_limit, std::numeric_limits<int>::max()));
+    if (time_limit_ms > 0) {
+        playouts_left.store(limit > 0 ? limit : std::numeric_limits<int>::max(), std::memory_order_relaxed);
+    } else {
+        playouts_left.store(limit > 0 ? std::min(PLAYOUTS, limit) : PLAYOUTS, std::memory_order_relaxed);
+    }
+    deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(time_limit_ms);
+
+    auto task = [this](int index) { run_worker(*workers[index]); };
+    helper_threads.run(thread_count, task);
+
+    for (int i = 0; i < thread_count; i++) {
+        SEARCH_STAT(stats.merge(workers[i]->stats));
+        max_depth = std::max(max_depth, workers[i]->max_depth);
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::run_worker(Worker& worker) {
+    while (budget_left()) {
+        playout(worker);
+    }
+}
+
+template <int COLUMNS, int ROWS>
+bool MctsAlgorithm<COLUMNS, ROWS>::budget_left() {
+    // Stopped or interrupted, the playouts so far decide the move
+    if (stop_signal && stop_signal->load(std::memory_order_relaxed)) {
+        return false;
+    }
+    if (interrupt_signal && interrupt_signal->load(std::memory_order_relaxed)) {
+        return false;
+    }
+    if (time_limit_ms > 0 && std::chrono::steady_clock::now() >= deadline) {
+        return false;
+    }
+    return playouts_left.fetch_sub(1, std::memory_order_relaxed) > 0;
+}
+
+// Select down the tree, expand, finish the game with a rollout and back the
+// result up. Each node's visit is counted on the way down (virtual loss).
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::playout(Worker& worker) {
+    Node* pool = pools[active].get();
+    worker.path.clear();
+    worker.played.clear();
+
+    uint32_t index = root;
+    int side = root_side;
+    int winner = -2; // -1 draw, otherwise the winning side
+    pool[index].visits.fetch_add(1, std::memory_order_relaxed);
+    worker.path.push_back(static_cast<int>(index));
+
+    while (true) {
+        Node& node = pool[index];
+        if (node.wins) {
+            winner = 1 - side;
+            break;
+        }
+
+        uint8_t state = node.state.load(std::memory_order_acquire);
+        if (state == LEAF && (index == root || node.visits.load(std::memory_order_relaxed) >= EXPAND_VISITS)) {
+            uint8_t expected = LEAF;
+            if (node.state.compare_exchange_strong(expected, EXPANDING, std::memory_order_acq_rel)) {
+                expand(worker, node, side, index == root ? root_children : children);
+            }
+            state = node.state.load(std::memory_order_acquire);
+        }
+        if (state != EXPANDED) {
+            break;
+        }
+
+        index = select_child(node);
+        Node& child = pool[index];
+        child.visits.fetch_add(1, std::memory_order_relaxed);
+        worker.path.push_back(static_cast<int>(index));
+
+        int x = child.move / ROW;
+        int y = child.move % ROW;
+        worker.board.place(x, y, side);
+        worker.candidates.place(x, y);
+        worker.evaluator.update(worker.board, x, y);
+        worker.played.push_back(child.move);
+        side = 1 - side;
+    }
+
+    int tree_moves = worker.played.size();
+    worker.max_depth = std::max(worker.max_depth, tree_moves);
+    SEARCH_STAT(worker.stats.nodes_at_ply[SearchStats::ply_slot(tree_moves)]++);
+    if (winner == -2) {
+        winner = rollout(worker, side);
+    }
+    SEARCH_STAT(worker.stats.playouts++);
+    SEARCH_STAT(worker.stats.nodes += worker.played.size());
+
+    // The move into path[k] was made by root_side for odd k
+    for (int k = 1; k < worker.path.size(); k++) {
+        int mover = (k & 1) ? root_side : 1 - root_side;
+        uint32_t points = winner == mover ? 2 : (winner == -1 ? 1 : 0);
+        pool[worker.path[k]].value.fetch_add(points, std::memory_order_relaxed);
+    }
+
+    // Rollout stones never touched the evaluator; tree stones did
+    for (int k = worker.played.size() - 1; k >= 0; k--) {
+        int cell = worker.played[k];
+        int x = cell / ROW;
+        int y = cell % ROW;
+        worker.board.remove(x, y, (k & 1) ? 1 - root_side : root_side);
+        worker.candidates.remove(x, y);
+        if (k < tree_moves) {
+            worker.evaluator.update(worker.board, x, y);
+        }
+    }
+}
+
+// PUCT: mean value plus an exploration term led by the prior
+template <int COLUMNS, int ROWS>
+uint32_t MctsAlgorithm<COLUMNS, ROWS>::select_child(const Node& node) const {
+    const Node* pool = pools[active].get();
+    double scale = EXPLORATION * std::sqrt(static_cast<double>(node.visits.load(std::memory_order_relaxed)));
+
+    uint32_t best = node.first_child;
+    double best_score = -1.0;
+    for (int k = 0; k < node.child_count; k++) {
+        const Node& child = pool[node.first_child + k];
+        if (child.wins) {
+            return node.first_child + k;
+        }
+        uint32_t visits = child.visits.load(std::memory_order_relaxed);
+        double value = visits > 0 ? child.value.load(std::memory_order_relaxed) / (2.0 * visits) : FIRST_PLAY_VALUE;
+        double score = value + scale * child.prior / (1 + visits);
+        if (score > best_score) {
+            best_score = score;
+            best = node.first_child + k;
+        }
+    }
+    return best;
+}
+
+// Children are the best width moves by shape evaluation. A five to complete
+// or to block leaves a single child.
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::expand(Worker& worker, Node& node, int side, int width) {
+    std::array<std::pair<int, int>, CELLS> scored; // score, cell
+    int count = 0;
+    bool wins = false;
+
+    int forced = worker.board.five_point(side);
+    if (forced >= 0) {
+        wins = true;
+    } else {
+        forced = worker.board.five_point(1 - side);
+    }
+
+    if (forced >= 0) {
+        scored[count++] = {0, forced};
+    } else {
+        for (int cell : worker.candidates) {
+            int x = cell / ROW;
+            int y = cell % ROW;
+            worker.board.place(x, y, side);
+            worker.evaluator.update(worker.board, x, y);
+            scored[count++] = {evaluation(worker.evaluator, side), cell};
+            worker.board.remove(x, y, side);
+            worker.evaluator.update(worker.board, x, y);
+        }
+        SEARCH_STAT(worker.stats.evaluations += count);
+    }
+
+    if (count == 0) {
+        // Full board: stays a leaf, every playout through it is a draw
+        node.state.store(LEAF, std::memory_order_release);
+        return;
+    }
+
+    // Best first, board order between equal scores
+    int kept = std::min(count, width);
+    std::partial_sort(scored.begin(), scored.begin() + kept, scored.begin() + count,
+                      [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+                          return a.first != b.first ? a.first > b.first : a.second < b.second;
+                      });
+
+    // A full pool stops growing the tree; the playouts go on from its leaves
+    uint32_t first = pool_used.load(std::memory_order_relaxed);
+    if (first + kept <= pool_size) {
+        first = pool_used.fetch_add(kept, std::memory_order_relaxed);
+    }
+    if (first + kept > pool_size) {
+        node.state.store(POOL_FULL, std::memory_order_release);
+        return;
+    }
+
+    // Softmax of the scores
+    double weights[MAX_CHILDREN];
+    double total = 0;
+    for (int k = 0; k < kept; k++) {
+        weights[k] = std::exp((scored[k].first - scored[0].first) / PRIOR_TEMPERATURE);
+        total += weights[k];
+    }
+
+    Node* pool = pools[active].get();
+    for (int k = 0; k < kept; k++) {
+        init_node(pool[first + k], scored[k].second, static_cast<float>(weights[k] / total), wins);
+    }
+    node.first_child = first;
+    node.child_count = static_cast<uint8_t>(kept);
+    node.state.store(EXPANDED, std::memory_order_release);
+}
+
+// Pattern-biased playout to the end of the game: win if possible, else block,
+// else a random cell next to a stone. Returns the winner, -1 for a draw.
+template <int COLUMNS, int ROWS>
+int MctsAlgorithm<COLUMNS, ROWS>::rollout(Worker& worker, int side) {
+    while (!worker.candidates.empty()) {
+        if (worker.board.five_point(side) >= 0) {
+            return side;
+        }
+        int cell = worker.board.five_point(1 - side);
+        if (cell < 0) {
+            cell = worker.candidates.begin()[worker.rng() % worker.candidates.size()];
+        }
+        int x = cell / ROW;
+        int y = cell % ROW;
+        worker.board.place(x, y, side);
+        worker.candidates.place(x, y);
+        worker.played.push_back(cell);
+        side = 1 - side;
+    }
+    return -1;
+}
+
+template <int COLUMNS, int ROWS>
+int MctsAlgorithm<COLUMNS, ROWS>::evaluation(const ShapeEvaluator<COLUMNS, ROWS>& shapes, int side) const {
+    // Same weighting as MinimaxAlgorithm: my score - enemy score * ratio * 0.1
+    return shapes.score(side) - static_cast<int>(shapes.score(1 - side) * ratio * 0.1);
+}
+
+template <int COLUMNS, int ROWS>
+std::map<std::string, int> MctsAlgorithm<COLUMNS, ROWS>::get_statistics() const {
+    return {
+        {"playouts", static_cast<int>(stats.playouts)},
+        {"search_count", static_cast<int>(stats.nodes)},
+        {"tree_nodes", static_cast<int>(std::min(pool_used.load(), pool_size))},
+        {"depth", stats.depth},
+        {"threads", thread_count},
+        {"threat_nodes", static_cast<int>(stats.threat_nodes)}
+    };
+}
+
+// Memory for both pools; drops the tree
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::set_tt_size(std::size_t megabytes) {
+    std::size_t nodes = (std::max<std::size_t>(1, megabytes) << 20) / 2 / sizeof(Node);
+    pool_size = static_cast<uint32_t>(std::min<std::size_t>(nodes, NO_NODE - 1));
+    pools[0] = std::make_unique<Node[]>(pool_size);
+    pools[1] = std::make_unique<Node[]>(pool_size);
+    active = 0;
+    reset_tree(root_side);
+}
+
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::set_time_limit(int milliseconds) {
+    time_limit_ms = milliseconds;
+}
+
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::set_threads(int threads) {
+    thread_count = std::max(1, threads);
+
+    // Workers and their threads are made here, once, so searches never allocate
+    while (static_cast<int>(workers.size()) < thread_count) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    helper_threads.start(thread_count);
+}
+
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::set_candidate_radius(int radius_input) {
+    radius = std::max(1, radius_input);
+    candidates = CandidateSet<COLUMNS, ROWS>(radius);
+    for (int cell : all_pieces) {
+        candidates.place(cell / ROW, cell % ROW);
+    }
+    // Children were picked from the old candidates
+    reset_tree(root_side);
+}
+
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::set_threat_search(bool enabled) {
+    use_threat_search = enabled;
+}
+
+// The beam is the number of children per expansion
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::set_beam(int width, int root_width) {
+    children = width > 0 ? std::min(width, MAX_CHILDREN) : DEFAULT_CHILDREN;
+    root_children = width > 0 ? std::min(2 * width, MAX_CHILDREN) : DEFAULT_CHILDREN;
+    if (root_width > 0) {
+        root_children = std::min(root_width, MAX_CHILDREN);
+    }
+    // Nodes were expanded with the old widths
+    reset_tree(root_side);
+}
+
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::set_stop_signal(const std::atomic<bool>* signal) {
+    stop_signal = signal;
+}
+
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::set_interrupt_signal(const std::atomic<bool>* signal) {
+    interrupt_signal = signal;
+}
+
+template <int COLUMNS, int ROWS>
+void MctsAlgorithm<COLUMNS, ROWS>::set_node_limit(uint64_t nodes) {
+    node_limit = nodes;
+}
+
+template <int COLUMNS, int ROWS>
+SearchEngine::Pieces MctsAlgorithm<COLUMNS, ROWS>::likely_moves(const Pieces& player_pieces_input,
+                                                                const Pieces& opponent_pieces_input, int count) {
+    load_position(player_pieces_input, opponent_pieces_input);
+
+    // Score every candidate by the position it leads to
+    std::vector<std::pair<int, int>> scored;
+    for (int cell : candidates) {
+        int i = cell / ROW;
+        int j = cell % ROW;
+        board.place(i, j, 0);
+        evaluator.update(board, i, j);
+        scored.push_back({evaluation(evaluator, 0), cell});
+        board.remove(i, j, 0);
+        evaluator.update(board, i, j);
+    }
+
+    // Best score first, board order between equal scores
+    std::sort(scored.begin(), scored.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    Pieces moves;
+    for (int k = 0; k < count && k < static_cast<int>(scored.size()); k++) {
+        moves.push_back({scored[k].second / ROW, scored[k].second % ROW});
+    }
+    return moves;
+}
+
+template <int COLUMNS, int ROWS>
+bool MctsAlgorithm<COLUMNS, ROWS>::check_win(const Pieces& pieces) {
+    Bitboard<COLUMNS, ROWS> pieces_board;
+    for (const auto& pt : pieces) {
+        if (pieces_board.in_bounds(pt.first, pt.second)) {
+            pieces_board.place(pt.first, pt.second, 0);
+        }
+    }
+    return pieces_board.has_five(0);
+}
+
+template class MctsAlgorithm<9, 9>;
+template class MctsAlgorithm<15, 15>;
+template class MctsAlgorithm<19, 19>;
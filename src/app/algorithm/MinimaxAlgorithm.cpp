@@ -1,353 +1,847 @@
 #include "MinimaxAlgorithm.hpp"
 #include <iostream>
 #include <algorithm>
+#include <thread>
+#include <cstdlib>
+
+// Threat-space search limits: depths in attacker moves, nodes per solver call
+static const int VCF_DEPTH = 12;
+static const int VCT_DEPTH = 4;
+static const long long THREAT_NODE_LIMIT = 20000;
+static const long long DEFENCE_NODE_LIMIT = 2000;
+
+// Move ordering tiers, above any history score
+static const long long ORDER_TT_MOVE = 1LL << 40;
+static const long long ORDER_WIN = 1LL << 39;
+static const long long ORDER_BLOCK = 1LL << 38;
+static const long long ORDER_KILLER = 1LL << 37;
+static const int HISTORY_LIMIT = 1 << 24;
+
+// Search window bounds, and the first aspiration half-width (about an open three)
+static const int SCORE_INF = 99999999;
+static const int ASPIRATION_WINDOW = 5000;
 
 // Constructor implementation
-MinimaxAlgorithm::MinimaxAlgorithm(std::pair<int, int> board_size, int search_depth, double attack_ratio) {
+template <int COLUMNS, int ROWS>
+MinimaxAlgorithm<COLUMNS, ROWS>::MinimaxAlgorithm(int search_depth, double attack_ratio,
+                                                  std::shared_ptr<TranspositionTable> table)
+    : candidates(1), evaluator(std::make_unique<ShapeEvaluator<COLUMNS, ROWS>>()),
+      tt(table ? std::move(table) : std::make_shared<TranspositionTable>()) {
     // Initialize basic parameters
-    COLUMN = board_size.first;
-    ROW = board_size.second;
     DEPTH = search_depth;
     ratio = attack_ratio;
     
     // Initialize statistics
-    cut_count = 0;
-    search_count = 0;
+    reset_statistics();
     
     // Initialize next move
     next_move = {0, 0};
+    root_move = {0, 0};
     
-    // Initialize all possible board positions
-    for (int i = 0; i <= COLUMN; i++) {
-        for (int j = 0; j <= ROW; j++) {
-            all_positions.push_back({i, j});
-        }
-    }
+    // Fixed-depth search unless a time limit is set
+    time_limit_ms = 0;
+    root_depth = DEPTH;
+    completed_depth = 0;
+    stop_search = false;
+    poll_count = 0;
     
-    // Initialize shape scoring table
-    shape_score = {
-        {50, {0, 1, 1, 0, 0}},
-        {50, {0, 0, 1, 1, 0}},
-        {200, {1, 1, 0, 1, 0}},
-        {500, {0, 0, 1, 1, 1}},
-        {500, {1, 1, 1, 0, 0}},
-        {5000, {0, 1, 1, 1, 0}},
-        {5000, {0, 1, 0, 1, 1, 0}},
-        {5000, {0, 1, 1, 0, 1, 0}},
-        {5000, {1, 1, 1, 0, 1}},
-        {5000, {1, 1, 0, 1, 1}},
-        {5000, {1, 0, 1, 1, 1}},
-        {5000, {1, 1, 1, 1, 0}},
-        {5000, {0, 1, 1, 1, 1}},
-        {50000, {0, 1, 1, 1, 1, 0}},
-        {99999999, {1, 1, 1, 1, 1}}
-    };
+    // Single-threaded unless asked otherwise
+    thread_count = 1;
+    helper_id = 0;
+    abort_signal = nullptr;
+    stop_signal = nullptr;
+    interrupt_signal = nullptr;
+    node_limit = 0;
+    search_nodes = 0;
+    helpers_synced = false;
+    
+    // A game never holds more stones than cells
+    player_pieces.reserve(CELLS);
+    opponent_pieces.reserve(CELLS);
+    
+    // Forced wins are checked before searching, inside the move's budget
+    use_threat_search = true;
+    threats.set_stop_check([](void* engine) { return static_cast<MinimaxAlgorithm*>(engine)->threats_out_of_budget(); },
+                           this);
+    
+    // Killer moves per ply and history per cell
+    killers.fill({-1, -1});
+    history[0].fill(0);
+    history[1].fill(0);
+    
+    // Narrow windows where they are safe
+    use_pvs = true;
+    use_aspiration = true;
+    
+    // Every candidate is searched unless beam mode is on
+    beam_width = 0;
+    root_beam_width = 0;
 }
 
-std::pair<int, int> MinimaxAlgorithm::get_next_move(
-    const std::vector<std::pair<int, int>>& player_pieces_input, 
-    const std::vector<std::pair<int, int>>& opponent_pieces_input
-) {
-    // Copy the input pieces
-    player_pieces = player_pieces_input;
-    opponent_pieces = opponent_pieces_input;
+template <int COLUMNS, int ROWS>
+std::pair<int, int> MinimaxAlgorithm<COLUMNS, ROWS>::get_next_move(const Pieces& player_pieces_input,
+                                                                   const Pieces& opponent_pieces_input) {
+    load_position(player_pieces_input, opponent_pieces_input);
+    return get_next_move();
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::new_game() {
+    player_pieces.clear();
+    opponent_pieces.clear();
+    all_pieces.clear();
+    board.clear();
+    candidates.clear();
+    evaluator->reset(board);
+    helpers_synced = false;
+    
+    // Move ordering learnt in the last game does not carry over
+    killers.fill({-1, -1});
+    history[0].fill(0);
+    history[1].fill(0);
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::make_move(std::pair<int, int> pos, bool is_ai) {
+    (is_ai ? player_pieces : opponent_pieces).push_back(pos);
+    all_pieces.push_back(pos.first * ROW + pos.second);
+    board.place(pos.first, pos.second, is_ai ? 0 : 1);
+    candidates.place(pos.first, pos.second);
+    evaluator->update(board, pos.first, pos.second);
     
-    // Create all_pieces by combining player and opponent pieces
-    all_pieces = player_pieces;
-    all_pieces.insert(all_pieces.end(), opponent_pieces.begin(), opponent_pieces.end());
+    if (helpers_synced) {
+        for (auto& helper : helpers) {
+            helper->make_move(pos, is_ai);
+        }
+    }
+}
+
+template <int COLUMNS, int ROWS>
+std::pair<int, int> MinimaxAlgorithm<COLUMNS, ROWS>::get_next_move() {
+    SEARCH_STAT(auto started = std::chrono::steady_clock::now());
     
     // Reset statistics
-    cut_count = 0;
-    search_count = 0;
+    reset_statistics();
+    search_nodes = 0;
+    tt->new_search();
+    age_ordering();
     
-    // Run the Minimax algorithm
-    negamax(true, DEPTH, -99999999, 99999999);
+    // The threat search spends from the same budget as the main search
+    deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(time_limit_ms);
+    
+    // A forced win is played straight away; a forced loss narrows the root moves
+    root_moves.clear();
+    std::pair<int, int> forced_move;
+    if (all_pieces.empty()) {
+        // No stone to grow candidates from: open in the centre
+        next_move = {COLUMN / 2, ROW / 2};
+        completed_depth = 0;
+    } else if (candidates.empty()) {
+        // Full board: there is no move to play
+        next_move = {-1, -1};
+        completed_depth = 0;
+    } else if (use_threat_search && solve_threats(forced_move)) {
+        next_move = forced_move;
+        stats.score = SCORE_INF;
+    } else if (thread_count > 1) {
+        parallel_search();
+    } else {
+        run_search();
+    }
+    root_moves.clear();
+    
+    stats.depth = completed_depth;
+    stats.threads = thread_count;
+    SEARCH_STAT(stats.elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count());
     
     // Return the best move
     return next_move;
 }
 
-std::map<std::string, int> MinimaxAlgorithm::get_statistics() const {
-    return {
-        {"cut_count", cut_count},
-        {"search_count", search_count}
-    };
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::load_position(const Pieces& player_pieces_input, const Pieces& opponent_pieces_input) {
+    // Copy the input pieces
+    player_pieces.assign(player_pieces_input.begin(), player_pieces_input.end());
+    opponent_pieces.assign(opponent_pieces_input.begin(), opponent_pieces_input.end());
+    
+    helpers_synced = false;
+    
+    // Load the position into all_pieces, the bitboard and the candidate set
+    all_pieces.clear();
+    board.clear();
+    candidates.clear();
+    for (const auto& pt : player_pieces) {
+        all_pieces.push_back(pt.first * ROW + pt.second);
+        board.place(pt.first, pt.second, 0);
+        candidates.place(pt.first, pt.second);
+    }
+    for (const auto& pt : opponent_pieces) {
+        all_pieces.push_back(pt.first * ROW + pt.second);
+        board.place(pt.first, pt.second, 1);
+        candidates.place(pt.first, pt.second);
+    }
+    evaluator->reset(board);
 }
 
-int MinimaxAlgorithm::negamax(bool is_ai, int depth, int alpha, int beta) {
-    // Check if the game is over or if the search depth is reached
-    if (check_win(player_pieces) || check_win(opponent_pieces) || depth == 0) {
-        return evaluation(is_ai);
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::reset_statistics() {
+    stats = SearchStats{};
+}
+
+template <int COLUMNS, int ROWS>
+bool MinimaxAlgorithm<COLUMNS, ROWS>::solve_threats(std::pair<int, int>& move) {
+    // Attack: our own forced win
+    threats.set_node_limit(THREAT_NODE_LIMIT);
+    bool found = threats.find_vcf(board, 0, VCF_DEPTH, move);
+    SEARCH_STAT(stats.threat_nodes += threats.nodes());
+    if (!found && !threats.stopped()) {
+        found = threats.find_vct(board, 0, VCT_DEPTH, move);
+        SEARCH_STAT(stats.threat_nodes += threats.nodes());
+    }
+    if (found) {
+        completed_depth = 0;
+        return true;
     }
     
-    // Get all empty positions by finding differences between all positions and placed pieces
-    std::vector<std::pair<int, int>> blank_list;
-    for (const auto& pos : all_positions) {
-        if (std::find(all_pieces.begin(), all_pieces.end(), pos) == all_pieces.end()) {
-            blank_list.push_back(pos);
+    // Defence: keep the root moves after which the opponent has no forced win
+    if (!opponent_has_forced_win()) {
+        return false;
+    }
+    threats.set_node_limit(DEFENCE_NODE_LIMIT);
+    for (int cell : candidates) {
+        int i = cell / ROW;
+        int j = cell % ROW;
+        board.place(i, j, 0);
+        if (!opponent_has_forced_win()) {
+            root_moves.push_back(cell);
+        }
+        board.remove(i, j, 0);
+        
+        // Out of time: an unfinished list would drop moves never checked
+        if (threats.stopped()) {
+            root_moves.clear();
+            break;
         }
     }
+    return false;
+}
+
+template <int COLUMNS, int ROWS>
+bool MinimaxAlgorithm<COLUMNS, ROWS>::opponent_has_forced_win() {
+    std::pair<int, int> move;
+    bool found = threats.find_vcf(board, 1, VCF_DEPTH, move);
+    SEARCH_STAT(stats.threat_nodes += threats.nodes());
+    if (!found && !threats.stopped()) {
+        found = threats.find_vct(board, 1, VCT_DEPTH, move);
+        SEARCH_STAT(stats.threat_nodes += threats.nodes());
+    }
+    return found;
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::run_search() {
+    // No move of an earlier search may survive a stop before the root orders its moves
+    root_move = {-1, -1};
+    next_move = {-1, -1};
     
-    // Sort search order to improve pruning efficiency
-    order_moves(blank_list);
-    
-    // Iterate through each candidate move
-    for (const auto& next_step : blank_list) {
-        search_count++;
+    if (time_limit_ms > 0) {
+        iterative_deepening();
+    } else {
+        root_depth = DEPTH;
+        stop_search = false;
+        poll_count = 0;
+        int score = negamax(true, DEPTH, -SCORE_INF, SCORE_INF);
         
-        // Skip positions without adjacent pieces (reduce computation)
-        if (!has_neighbor(next_step)) {
-            continue;
+        // Cut short, the best root move searched so far is played
+        next_move = root_move;
+        completed_depth = stop_search ? 0 : DEPTH;
+        if (!stop_search) {
+            stats.score = score;
         }
-        
-        // Simulate placing a piece
-        if (is_ai) {
-            player_pieces.push_back(next_step);
-        } else {
-            opponent_pieces.push_back(next_step);
+        SEARCH_STAT(stats.iteration_nodes[SearchStats::ply_slot(DEPTH)] = stats.nodes);
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::parallel_search() {
+    // Helpers follow make_move() once they hold the position
+    if (!helpers_synced) {
+        for (auto& helper : helpers) {
+            helper->load_position(player_pieces, opponent_pieces);
         }
-        all_pieces.push_back(next_step);
-        
-        // Recursive search
-        int value = -negamax(!is_ai, depth - 1, -beta, -alpha);
-        
-        // Undo the move
-        if (is_ai) {
-            player_pieces.pop_back();
+        helpers_synced = true;
+    }
+    
+    std::atomic<bool> abort_helpers(false);
+    for (int i = 0; i < thread_count - 1; i++) {
+        MinimaxAlgorithm* helper = helpers[i].get();
+        helper->reset_statistics();
+        helper->age_ordering();
+        helper->abort_signal = &abort_helpers;
+    }
+    
+    // The main search alone decides the move, then stops the helpers
+    auto task = [this, &abort_helpers](int index) {
+        if (index == 0) {
+            run_search();
+            abort_helpers = true;
         } else {
-            opponent_pieces.pop_back();
-        }
-        all_pieces.pop_back();
-        
-        // Update the best value
-        if (value > alpha) {
-            if (depth == DEPTH) {
-                next_move = next_step;
-            }
-            
-            // Alpha-beta pruning
-            if (value >= beta) {
-                cut_count++;
-                return beta;
-            }
-            alpha = value;
+            helpers[index - 1]->helper_search();
         }
+    };
+    helper_threads.run(thread_count, task);
+    
+    for (int i = 0; i < thread_count - 1; i++) {
+        SEARCH_STAT(stats.merge(helpers[i]->stats));
+        helpers[i]->abort_signal = nullptr;
     }
+}
+
+// Helper thread: deepen until the main search is done. Odd helpers skip
+// a depth ahead so threads spread over different iterations.
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::helper_search() {
+    int max_depth = time_limit_ms > 0 ? CELLS - all_pieces.size() : DEPTH;
+    stop_search = false;
+    poll_count = 0;
     
-    return alpha;
+    for (int depth = 1 + (helper_id & 1); depth <= max_depth && !stop_search; depth++) {
+        root_depth = depth;
+        negamax(true, depth, -SCORE_INF, SCORE_INF);
+    }
 }
 
-void MinimaxAlgorithm::order_moves(std::vector<std::pair<int, int>>& blank_list) {
-    if (all_pieces.empty()) {
+template <int COLUMNS, int ROWS>
+std::map<std::string, int> MinimaxAlgorithm<COLUMNS, ROWS>::get_statistics() const {
+    return {
+        {"cut_count", static_cast<int>(stats.cutoffs)},
+        {"search_count", static_cast<int>(stats.nodes)},
+        {"tt_hits", static_cast<int>(stats.tt_hits)},
+        {"tt_misses", static_cast<int>(stats.tt_probes - stats.tt_hits - stats.tt_collisions)},
+        {"tt_collisions", static_cast<int>(stats.tt_collisions)},
+        {"depth", completed_depth},
+        {"threads", thread_count},
+        {"threat_nodes", static_cast<int>(stats.threat_nodes)},
+        {"pvs_researches", static_cast<int>(stats.pvs_researches)},
+        {"aspiration_researches", static_cast<int>(stats.aspiration_researches)}
+    };
+}
+
+// Every setter below passes its option on to the helpers, so they search the
+// same moves the same way as the main search and agree on the table's scores
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::set_time_limit(int milliseconds) {
+    time_limit_ms = milliseconds;
+    for (auto& helper : helpers) {
+        helper->set_time_limit(milliseconds);
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::set_threads(int threads) {
+    thread_count = std::max(1, threads);
+    
+    // Helpers and their threads are made here, once, so searches never allocate
+    while (static_cast<int>(helpers.size()) < thread_count - 1) {
+        auto helper = std::make_unique<MinimaxAlgorithm>(DEPTH, ratio, tt);
+        helper->helper_id = static_cast<int>(helpers.size()) + 1;
+        helper->set_time_limit(time_limit_ms);
+        helper->set_candidate_radius(candidates.radius());
+        helper->set_threat_search(use_threat_search);
+        helper->set_pvs(use_pvs);
+        helper->set_aspiration(use_aspiration);
+        helper->beam_width = beam_width;
+        helper->root_beam_width = root_beam_width;
+        helper->set_evaluator(eval_weights);
+        helpers.push_back(std::move(helper));
+        helpers_synced = false;
+    }
+    helper_threads.start(thread_count);
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::set_candidate_radius(int radius) {
+    candidates = CandidateSet<COLUMNS, ROWS>(std::max(1, radius));
+    for (int cell : all_pieces) {
+        candidates.place(cell / ROW, cell % ROW);
+    }
+    for (auto& helper : helpers) {
+        helper->set_candidate_radius(radius);
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::set_threat_search(bool enabled) {
+    use_threat_search = enabled;
+    for (auto& helper : helpers) {
+        helper->set_threat_search(enabled);
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::set_pvs(bool enabled) {
+    use_pvs = enabled;
+    for (auto& helper : helpers) {
+        helper->set_pvs(enabled);
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::set_aspiration(bool enabled) {
+    use_aspiration = enabled;
+    for (auto& helper : helpers) {
+        helper->set_aspiration(enabled);
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::set_beam(int width, int root_width) {
+    beam_width = std::max(0, width);
+    root_beam_width = root_width > 0 ? root_width : 2 * beam_width;
+    for (auto& helper : helpers) {
+        helper->beam_width = beam_width;
+        helper->root_beam_width = root_beam_width;
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::set_evaluator(std::shared_ptr<const PatternWeights> weights) {
+    eval_weights = weights;
+    if (weights) {
+        evaluator = std::make_unique<LinearEvaluator<COLUMNS, ROWS>>(weights);
+    } else {
+        evaluator = std::make_unique<ShapeEvaluator<COLUMNS, ROWS>>();
+    }
+    evaluator->reset(board);
+    for (auto& helper : helpers) {
+        helper->set_evaluator(weights);
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::set_stop_signal(const std::atomic<bool>* signal) {
+    stop_signal = signal;
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::set_interrupt_signal(const std::atomic<bool>* signal) {
+    interrupt_signal = signal;
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::set_node_limit(uint64_t nodes) {
+    node_limit = nodes;
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::set_tt(std::shared_ptr<TranspositionTable> table) {
+    // An engine without a table has nothing to share
+    if (!table) {
         return;
     }
+    tt = std::move(table);
+    for (auto& helper : helpers) {
+        helper->tt = tt;
+    }
+}
+
+template <int COLUMNS, int ROWS>
+SearchEngine::Pieces MinimaxAlgorithm<COLUMNS, ROWS>::likely_moves(const Pieces& player_pieces_input,
+                                                                   const Pieces& opponent_pieces_input, int count) {
+    load_position(player_pieces_input, opponent_pieces_input);
     
-    auto last_pt = all_pieces.back();
+    // Score every candidate by the position it leads to
+    std::vector<std::pair<int, int>> scored;
+    for (int cell : candidates) {
+        int i = cell / ROW;
+        int j = cell % ROW;
+        board.place(i, j, 0);
+        evaluator->update(board, i, j);
+        scored.push_back({evaluation(true), cell});
+        board.remove(i, j, 0);
+        evaluator->update(board, i, j);
+    }
     
-    for (int i = -1; i <= 1; i++) {
-        for (int j = -1; j <= 1; j++) {
-            if (i == 0 && j == 0) {
-                continue;
+    // Best score first, board order between equal scores
+    std::sort(scored.begin(), scored.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    
+    Pieces moves;
+    for (int k = 0; k < count && k < static_cast<int>(scored.size()); k++) {
+        moves.push_back({scored[k].second / ROW, scored[k].second % ROW});
+    }
+    return moves;
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::iterative_deepening() {
+    // deadline was set by get_next_move(), before the threat search
+    completed_depth = 0;
+    
+    // Deeper than the number of empty cells can't change anything
+    int max_depth = CELLS - all_pieces.size();
+    int score = 0;
+    
+    for (int depth = 1; depth <= max_depth; depth++) {
+        root_depth = depth;
+        // Depth 1 always completes so there is a move to return
+        stop_search = false;
+        poll_count = 0;
+        
+        SEARCH_STAT(uint64_t nodes_before = stats.nodes);
+        
+        // Aspiration window around the last score, widened on the failing side until the score fits
+        int alpha = -SCORE_INF;
+        int beta = SCORE_INF;
+        int delta = ASPIRATION_WINDOW;
+        if (use_aspiration && depth > 1) {
+            alpha = std::max(-SCORE_INF, score - delta);
+            beta = std::min(SCORE_INF, score + delta);
+        }
+        while (true) {
+            score = negamax(true, depth, alpha, beta);
+            bool fail_low = score <= alpha && alpha > -SCORE_INF;
+            bool fail_high = score >= beta && beta < SCORE_INF;
+            if (stop_search || (!fail_low && !fail_high)) {
+                break;
             }
-            
-            std::pair<int, int> pos = {last_pt.first + i, last_pt.second + j};
-            auto it = std::find(blank_list.begin(), blank_list.end(), pos);
-            
-            if (it != blank_list.end()) {
-                blank_list.erase(it);
-                blank_list.insert(blank_list.begin(), pos);
+            SEARCH_STAT(stats.aspiration_researches++);
+            delta *= 4;
+            if (fail_low) {
+                alpha = std::max(-SCORE_INF, score - delta);
+            } else {
+                beta = std::min(SCORE_INF, score + delta);
+            }
+        }
+        
+        if (stop_search) {
+            // Stopped during depth 1: the best root move so far is played
+            if (completed_depth == 0) {
+                next_move = root_move;
             }
+            break;
+        }
+        
+        // Only a finished iteration decides the move
+        next_move = root_move;
+        completed_depth = depth;
+        stats.score = score;
+        SEARCH_STAT(stats.iteration_nodes[SearchStats::ply_slot(depth)] = stats.nodes - nodes_before);
+        
+        if (out_of_budget()) {
+            break;
         }
     }
+    stop_search = false;
 }
 
-bool MinimaxAlgorithm::has_neighbor(const std::pair<int, int>& point) {
-    for (int i = -1; i <= 1; i++) {
-        for (int j = -1; j <= 1; j++) {
-            if (i == 0 && j == 0) {
-                continue;
+// Poll the clock (or the stop and helper abort signals) every few hundred nodes.
+// The budget never stops depth 1, so there is always a move to return.
+template <int COLUMNS, int ROWS>
+bool MinimaxAlgorithm<COLUMNS, ROWS>::time_up() {
+    if (stop_search) {
+        return true;
+    }
+    if ((++poll_count & 255) != 0) {
+        return false;
+    }
+    if (stop_signal && stop_signal->load(std::memory_order_relaxed)) {
+        stop_search = true;
+    } else if (abort_signal) {
+        stop_search = abort_signal->load(std::memory_order_relaxed);
+    } else if (root_depth > 1) {
+        stop_search = out_of_budget();
+    }
+    return stop_search;
+}
+
+// Interrupted, out of nodes or out of time
+template <int COLUMNS, int ROWS>
+bool MinimaxAlgorithm<COLUMNS, ROWS>::out_of_budget() {
+    if (interrupt_signal && interrupt_signal->load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (node_limit > 0 && search_nodes >= node_limit) {
+        return true;
+    }
+    return time_limit_ms > 0 && std::chrono::steady_clock::now() >= deadline;
+}
+
+// Stop or interrupt signal, or the move's budget spent
+template <int COLUMNS, int ROWS>
+bool MinimaxAlgorithm<COLUMNS, ROWS>::threats_out_of_budget() {
+    if (stop_signal && stop_signal->load(std::memory_order_relaxed)) {
+        return true;
+    }
+    return out_of_budget();
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::set_tt_size(std::size_t megabytes) {
+    tt->resize(megabytes);
+}
+
+template <int COLUMNS, int ROWS>
+int MinimaxAlgorithm<COLUMNS, ROWS>::negamax(bool is_ai, int depth, int alpha, int beta) {
+    // Check if the game is over or if the search depth is reached
+    if (board.has_five(0) || board.has_five(1) || depth == 0) {
+        return evaluation(is_ai);
+    }
+    
+    // Out of time: the unfinished iteration is thrown away
+    if (time_up()) {
+        return 0;
+    }
+    
+    // Full board: a draw. Returning alpha here would leave the root without a move
+    if (candidates.empty()) {
+        return 0;
+    }
+    
+    // Probe the transposition table; the root always searches to get a move
+    uint64_t key = board.hash() ^ (is_ai ? 0 : BitboardBase::SIDE_KEY);
+    int tt_move = -1;
+    TranspositionTable::Entry entry;
+    TranspositionTable::ProbeResult probe = tt->probe(key, entry);
+    SEARCH_STAT(stats.tt_probes++);
+    if (probe == TranspositionTable::COLLISION) {
+        SEARCH_STAT(stats.tt_collisions++);
+    } else if (probe == TranspositionTable::HIT) {
+        SEARCH_STAT(stats.tt_hits++);
+        tt_move = entry.move;
+        if (depth != root_depth && entry.depth >= depth) {
+            if (entry.bound == TranspositionTable::EXACT) {
+                return entry.score;
             }
-            
-            std::pair<int, int> neighbor = {point.first + i, point.second + j};
-            if (std::find(all_pieces.begin(), all_pieces.end(), neighbor) != all_pieces.end()) {
-                return true;
+            if (entry.bound == TranspositionTable::LOWER && entry.score >= beta) {
+                return beta;
+            }
+            if (entry.bound == TranspositionTable::UPPER && entry.score <= alpha) {
+                return alpha;
             }
         }
     }
-    return false;
-}
-
-int MinimaxAlgorithm::evaluation(bool is_ai) {
-    std::vector<std::pair<int, int>> my_list;
-    std::vector<std::pair<int, int>> enemy_list;
+    int alpha_orig = alpha;
+    int best_move = -1;
+    int side = is_ai ? 0 : 1;
+    int ply = root_depth - depth;
     
-    if (is_ai) {
-        my_list = player_pieces;
-        enemy_list = opponent_pieces;
-    } else {
-        my_list = opponent_pieces;
-        enemy_list = player_pieces;
+    // Candidate moves, in board order so the search does not depend on set history
+    MoveList<CELLS> moves;
+    for (int cell : candidates) {
+        moves.push_back(cell);
     }
+    std::sort(moves.begin(), moves.end());
     
-    // Calculate the score for oneself
-    std::vector<std::tuple<int, std::vector<std::pair<int, int>>, std::pair<int, int>>> score_all_arr;
-    int my_score = 0;
+    // Only moves that stop a forced loss are tried at the root
+    if (depth == root_depth && !root_moves.empty()) {
+        moves.resize(std::remove_if(moves.begin(), moves.end(), [this](int cell) {
+            return !root_moves.contains(cell);
+        }) - moves.begin());
+    }
     
-    for (const auto& pt : my_list) {
-        int m = pt.first;
-        int n = pt.second;
-        my_score += cal_score(m, n, 0, 1, enemy_list, my_list, score_all_arr);
-        my_score += cal_score(m, n, 1, 0, enemy_list, my_list, score_all_arr);
-        my_score += cal_score(m, n, 1, 1, enemy_list, my_list, score_all_arr);
-        my_score += cal_score(m, n, -1, 1, enemy_list, my_list, score_all_arr);
+    // Beam mode: only the best few by static evaluation. One ply from the
+    // horizon that scoring would cost as much as searching every move.
+    int width = depth == root_depth ? root_beam_width : beam_width;
+    if (width > 0 && depth > 1 && moves.size() > width) {
+        beam_prune(moves, is_ai, width);
     }
     
-    // Calculate the score for the enemy
-    std::vector<std::tuple<int, std::vector<std::pair<int, int>>, std::pair<int, int>>> score_all_arr_enemy;
-    int enemy_score = 0;
+    // Sort search order to improve pruning efficiency
+    order_moves(moves, side, ply, tt_move);
     
-    for (const auto& pt : enemy_list) {
-        int m = pt.first;
-        int n = pt.second;
-        enemy_score += cal_score(m, n, 0, 1, my_list, enemy_list, score_all_arr_enemy);
-        enemy_score += cal_score(m, n, 1, 0, my_list, enemy_list, score_all_arr_enemy);
-        enemy_score += cal_score(m, n, 1, 1, my_list, enemy_list, score_all_arr_enemy);
-        enemy_score += cal_score(m, n, -1, 1, my_list, enemy_list, score_all_arr_enemy);
+    // Helpers try the root moves in a different order for diversity
+    if (helper_id > 0 && depth == root_depth && moves.size() > 2) {
+        std::rotate(moves.begin() + 1, moves.begin() + 1 + helper_id % (moves.size() - 1), moves.end());
     }
     
-    // Total score = My score - Enemy score * ratio * 0.1
-    return my_score - static_cast<int>(enemy_score * ratio * 0.1);
-}
-
-int MinimaxAlgorithm::cal_score(
-    int m, int n, int x_direct, int y_direct, 
-    const std::vector<std::pair<int, int>>& enemy_list,
-    const std::vector<std::pair<int, int>>& my_list,
-    std::vector<std::tuple<int, std::vector<std::pair<int, int>>, std::pair<int, int>>>& score_all_arr
-) {
-    int add_score = 0;
-    std::pair<int, std::vector<std::pair<int, int>>> max_score_shape = {0, {}};
-    std::pair<int, int> direction = {x_direct, y_direct};
-    
-    // Check if this direction has been calculated
-    for (const auto& item : score_all_arr) {
-        for (const auto& pt : std::get<1>(item)) {
-            if (m == pt.first && n == pt.second && 
-                x_direct == std::get<2>(item).first && 
-                y_direct == std::get<2>(item).second) {
-                return 0;
-            }
-        }
+    // An interrupted search plays the best root move so far, the first one until another beats it
+    if (depth == root_depth && !moves.empty()) {
+        root_move = {moves[0] / ROW, moves[0] % ROW};
     }
     
-    // Scan in a specific direction to find shapes
-    for (int offset = -5; offset < 1; offset++) {
-        std::vector<int> pos;
-        std::vector<std::pair<int, int>> positions;
+    // Iterate through each candidate move
+    for (int cell : moves) {
+        search_nodes++;
+        SEARCH_STAT(stats.nodes++);
+        SEARCH_STAT(stats.nodes_at_ply[SearchStats::ply_slot(ply)]++);
+        std::pair<int, int> next_step = {cell / ROW, cell % ROW};
         
-        for (int i = 0; i < 6; i++) {
-            std::pair<int, int> point = {m + (i + offset) * x_direct, n + (i + offset) * y_direct};
-            positions.push_back(point);
-            
-            if (std::find(enemy_list.begin(), enemy_list.end(), point) != enemy_list.end()) {
-                pos.push_back(2);
-            } else if (std::find(my_list.begin(), my_list.end(), point) != my_list.end()) {
-                pos.push_back(1);
-            } else {
-                pos.push_back(0);
+        // Simulate placing a piece
+        board.place(next_step.first, next_step.second, is_ai ? 0 : 1);
+        candidates.place(next_step.first, next_step.second);
+        evaluator->update(board, next_step.first, next_step.second);
+        all_pieces.push_back(cell);
+        
+        // Recursive search; with PVS only moves until one raises alpha get the full window
+        int value;
+        if (!use_pvs || best_move < 0) {
+            value = -negamax(!is_ai, depth - 1, -beta, -alpha);
+        } else {
+            value = -negamax(!is_ai, depth - 1, -alpha - 1, -alpha);
+            if (value > alpha && value < beta && !stop_search) {
+                SEARCH_STAT(stats.pvs_researches++);
+                value = -negamax(!is_ai, depth - 1, -beta, -alpha);
             }
         }
         
-        std::vector<int> tmp_shape5(pos.begin(), pos.begin() + 5);
+        // Undo the move
+        board.remove(next_step.first, next_step.second, is_ai ? 0 : 1);
+        candidates.remove(next_step.first, next_step.second);
+        evaluator->update(board, next_step.first, next_step.second);
+        all_pieces.pop_back();
         
-        // Match shapes and score
-        for (const auto& shape_pair : shape_score) {
-            int score = shape_pair.first;
-            const auto& shape = shape_pair.second;
-            
-            bool matched = false;
-            
-            // Check for 5-length pattern
-            if (shape.size() == 5) {
-                matched = std::equal(shape.begin(), shape.end(), tmp_shape5.begin());
-            } 
-            // Check for 6-length pattern
-            else if (shape.size() == 6) {
-                matched = std::equal(shape.begin(), shape.end(), pos.begin());
+        if (stop_search) {
+            return 0;
+        }
+        
+        // Update the best value
+        if (value > alpha) {
+            best_move = cell;
+            if (depth == root_depth) {
+                root_move = next_step;
             }
             
-            if (matched && score > max_score_shape.first) {
-                std::vector<std::pair<int, int>> shape_positions;
-                for (int i = 0; i < 5; i++) {
-                    shape_positions.push_back({m + (i + offset) * x_direct, n + (i + offset) * y_direct});
-                }
-                max_score_shape = {score, shape_positions};
+            // Alpha-beta pruning
+            if (value >= beta) {
+                SEARCH_STAT(stats.cutoffs++);
+                SEARCH_STAT(stats.cutoffs_at_ply[SearchStats::ply_slot(ply)]++);
+                record_cutoff(side, ply, cell, depth);
+                tt->store(key, depth, TranspositionTable::LOWER, beta, best_move);
+                return beta;
             }
+            alpha = value;
         }
     }
     
-    // Calculate cross-score for shapes
-    if (!max_score_shape.second.empty()) {
-        for (const auto& item : score_all_arr) {
-            for (const auto& pt1 : std::get<1>(item)) {
-                for (const auto& pt2 : max_score_shape.second) {
-                    if (pt1 == pt2 && max_score_shape.first > 10 && std::get<0>(item) > 10) {
-                        add_score += std::get<0>(item) + max_score_shape.first;
-                    }
-                }
-            }
+    tt->store(key, depth, alpha > alpha_orig ? TranspositionTable::EXACT : TranspositionTable::UPPER,
+             alpha, best_move);
+    return alpha;
+}
+
+// Keep the width moves leading to the best static evaluation, in board order.
+// Moves completing or blocking a five rank above all others.
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::beam_prune(MoveList<CELLS>& moves, bool is_ai, int width) {
+    int side = is_ai ? 0 : 1;
+    std::array<std::pair<int, int>, CELLS> scored;
+    int count = 0;
+    for (int cell : moves) {
+        int x = cell / ROW;
+        int y = cell % ROW;
+        int score = SCORE_INF;
+        if (!board.makes_five(x, y, side) && !board.makes_five(x, y, 1 - side)) {
+            board.place(x, y, side);
+            evaluator->update(board, x, y);
+            score = evaluation(is_ai);
+            board.remove(x, y, side);
+            evaluator->update(board, x, y);
         }
-        
-        score_all_arr.push_back({max_score_shape.first, max_score_shape.second, direction});
+        scored[count++] = {score, cell};
     }
     
-    return add_score + max_score_shape.first;
+    std::partial_sort(scored.begin(), scored.begin() + width, scored.begin() + count,
+                      [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+                          return a.first != b.first ? a.first > b.first : a.second < b.second;
+                      });
+    moves.resize(width);
+    for (int i = 0; i < width; i++) {
+        moves[i] = scored[i].second;
+    }
+    std::sort(moves.begin(), moves.end());
 }
 
-bool MinimaxAlgorithm::check_win(const std::vector<std::pair<int, int>>& pieces) {
-    for (int m = 0; m < COLUMN; m++) {
-        for (int n = 0; n < ROW; n++) {
-            // Check horizontal direction
-            if (n < ROW - 4 &&
-                std::find(pieces.begin(), pieces.end(), std::make_pair(m, n)) != pieces.end() &&
-                std::find(pieces.begin(), pieces.end(), std::make_pair(m, n + 1)) != pieces.end() &&
-                std::find(pieces.begin(), pieces.end(), std::make_pair(m, n + 2)) != pieces.end() &&
-                std::find(pieces.begin(), pieces.end(), std::make_pair(m, n + 3)) != pieces.end() &&
-                std::find(pieces.begin(), pieces.end(), std::make_pair(m, n + 4)) != pieces.end()) {
-                return true;
-            }
-            
-            // Check vertical direction
-            else if (m < COLUMN - 4 &&
-                     std::find(pieces.begin(), pieces.end(), std::make_pair(m, n)) != pieces.end() &&
-                     std::find(pieces.begin(), pieces.end(), std::make_pair(m + 1, n)) != pieces.end() &&
-                     std::find(pieces.begin(), pieces.end(), std::make_pair(m + 2, n)) != pieces.end() &&
-                     std::find(pieces.begin(), pieces.end(), std::make_pair(m + 3, n)) != pieces.end() &&
-                     std::find(pieces.begin(), pieces.end(), std::make_pair(m + 4, n)) != pieces.end()) {
-                return true;
-            }
-            
-            // Check right diagonal
-            else if (m < COLUMN - 4 && n < ROW - 4 &&
-                     std::find(pieces.begin(), pieces.end(), std::make_pair(m, n)) != pieces.end() &&
-                     std::find(pieces.begin(), pieces.end(), std::make_pair(m + 1, n + 1)) != pieces.end() &&
-                     std::find(pieces.begin(), pieces.end(), std::make_pair(m + 2, n + 2)) != pieces.end() &&
-                     std::find(pieces.begin(), pieces.end(), std::make_pair(m + 3, n + 3)) != pieces.end() &&
-                     std::find(pieces.begin(), pieces.end(), std::make_pair(m + 4, n + 4)) != pieces.end()) {
-                return true;
-            }
-            
-            // Check left diagonal
-            else if (m < COLUMN - 4 && n > 3 &&
-                     std::find(pieces.begin(), pieces.end(), std::make_pair(m, n)) != pieces.end() &&
-                     std::find(pieces.begin(), pieces.end(), std::make_pair(m + 1, n - 1)) != pieces.end() &&
-                     std::find(pieces.begin(), pieces.end(), std::make_pair(m + 2, n - 2)) != pieces.end() &&
-                     std::find(pieces.begin(), pieces.end(), std::make_pair(m + 3, n - 3)) != pieces.end() &&
-                     std::find(pieces.begin(), pieces.end(), std::make_pair(m + 4, n - 4)) != pieces.end()) {
-                return true;
+// Order: TT move, our wins, blocks of the opponent's fives, killers, then
+// history. Cells next to the last stone break ties.
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::order_moves(MoveList<CELLS>& moves, int side, int ply, int tt_move) {
+    int last_x = all_pieces.empty() ? -9 : all_pieces.back() / ROW;
+    int last_y = all_pieces.empty() ? -9 : all_pieces.back() % ROW;
+    const std::array<int, 2>& killer = killers[ply];
+    
+    std::array<std::pair<long long, int>, CELLS> scored;
+    int count = 0;
+    for (int cell : moves) {
+        int x = cell / ROW;
+        int y = cell % ROW;
+        long long score = history[side][cell];
+        if (cell == tt_move) {
+            score += ORDER_TT_MOVE;
+        } else if (board.makes_five(x, y, side)) {
+            score += ORDER_WIN;
+        } else if (board.makes_five(x, y, 1 - side)) {
+            score += ORDER_BLOCK;
+        } else if (cell == killer[0] || cell == killer[1]) {
+            score += ORDER_KILLER + (cell == killer[0]);
+        }
+        bool near_last = std::abs(x - last_x) <= 1 && std::abs(y - last_y) <= 1;
+        scored[count++] = {score * 2 + near_last, cell};
+    }
+    
+    // Equal scores keep board order, as the moves come in board order
+    std::sort(scored.begin(), scored.begin() + count, [](const std::pair<long long, int>& a, const std::pair<long long, int>& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    for (int i = 0; i < count; i++) {
+        moves[i] = scored[i].second;
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::record_cutoff(int side, int ply, int cell, int depth) {
+    std::array<int, 2>& killer = killers[ply];
+    if (killer[0] != cell) {
+        killer[1] = killer[0];
+        killer[0] = cell;
+    }
+    
+    // Deeper cutoffs count more; halve everything before it can overflow
+    int& credit = history[side][cell];
+    credit += depth * depth;
+    if (credit > HISTORY_LIMIT) {
+        for (auto& table : history) {
+            for (int& h : table) {
+                h /= 2;
             }
         }
     }
+}
+
+// Between moves: killers belong to plies of the old root, history keeps half its weight
+template <int COLUMNS, int ROWS>
+void MinimaxAlgorithm<COLUMNS, ROWS>::age_ordering() {
+    killers.fill({-1, -1});
+    for (auto& table : history) {
+        for (int& h : table) {
+            h /= 2;
+        }
+    }
+}
+
+template <int COLUMNS, int ROWS>
+int MinimaxAlgorithm<COLUMNS, ROWS>::evaluation(bool is_ai) {
+    SEARCH_STAT(stats.evaluations++);
+    int my_side = is_ai ? 0 : 1;
+    int my_score = evaluator->score(my_side);
+    int enemy_score = evaluator->score(1 - my_side);
     
-    return false;
-} 
\ No newline at end of file
+    // Total score = My score - Enemy score * ratio * 0.1
+    return my_score - static_cast<int>(enemy_score * ratio * 0.1);
+}
+
+template <int COLUMNS, int ROWS>
+bool MinimaxAlgorithm<COLUMNS, ROWS>::check_win(const Pieces& pieces) {
+    Bitboard<COLUMNS, ROWS> pieces_board;
+    for (const auto& pt : pieces) {
+        if (pieces_board.in_bounds(pt.first, pt.second)) {
+            pieces_board.place(pt.first, pt.second, 0);
+        }
+    }
+    return pieces_board.has_five(0);
+}
+
+template class MinimaxAlgorithm<9, 9>;
+template class MinimaxAlgorithm<15, 15>;
+template class MinimaxAlgorithm<19, 19>;
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "OpeningBook.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char BOOK_MAGIC[8] = {'G', 'M', 'K', 'B', 'O', 'O', 'K', '1'};
+
+static_assert(sizeof(OpeningBook::Header) == 24, "book header layout");
+static_assert(sizeof(OpeningBook::Entry) == 16, "book entry layout");
+
+// Stone keys are a fixed function of (size, cell, side) so books stay valid across builds
+static uint64_t stone_key(int board_size, int cell, int side) {
+    uint64_t z = (static_cast<uint64_t>(board_size) << 32 | static_cast<uint64_t>(cell) << 1 | side)
+                 + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+OpeningBook::~OpeningBook() {
+    close();
+}
+
+bool OpeningBook::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        throw std::runtime_error("[Error] Opening book " + path + " is too small");
+    }
+
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("[Error] Failed to map opening book " + path);
+    }
+
+    const Header* header = static_cast<const Header*>(data);
+    std::size_t expected = sizeof(Header) + header->count * sizeof(Entry);
+    if (std::memcmp(header->magic, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0 ||
+        static_cast<std::size_t>(st.st_size) != expected) {
+        munmap(data, st.st_size);
+        throw std::runtime_error("[Error] " + path + " is not a valid opening book");
+    }
+
+    mapping = data;
+    mapping_size = st.st_size;
+    entries = reinterpret_cast<const Entry*>(static_cast<const char*>(data) + sizeof(Header));
+    count = header->count;
+    size = static_cast<int>(header->board_size);
+    return true;
+}
+
+void OpeningBook::close() {
+    if (mapping) {
+        munmap(mapping, mapping_size);
+    }
+    mapping = nullptr;
+    mapping_size = 0;
+    entries = nullptr;
+    count = 0;
+    size = 0;
+}
+
+bool OpeningBook::probe(const Pieces& to_move, const Pieces& other, std::pair<int, int>& move) const {
+    if (!is_open()) {
+        return false;
+    }
+
+    int symmetry;
+    uint64_t key = canonical_key(size, to_move, other, symmetry);
+    const Entry* end = entries + count;
+    const Entry* it = std::lower_bound(entries, end, key, [](const Entry& e, uint64_t k) { return e.key < k; });
+    if (it == end || it->key != key || it->move >= size * size) {
+        return false;
+    }
+
+    move = inverse(symmetry, {it->move / size, it->move % size}, size);
+    return true;
+}
+
+uint64_t OpeningBook::canonical_key(int board_size, const Pieces& to_move, const Pieces& other, int& symmetry) {
+    uint64_t best = 0;
+    symmetry = 0;
+    for (int s = 0; s < 8; s++) {
+        uint64_t key = 0;
+        for (int side = 0; side < 2; side++) {
+            for (const auto& pt : side == 0 ? to_move : other) {
+                auto [x, y] = transform(s, pt, board_size);
+                key ^= stone_key(board_size, x * board_size + y, side);
+            }
+        }
+        if (s == 0 || key < best) {
+            best = key;
+            symmetry = s;
+        }
+    }
+    return best;
+}
+
+std::pair<int, int> OpeningBook::transform(int symmetry, std::pair<int, int> pt, int n) {
+    auto [x, y] = pt;
+    if (symmetry & 4) {
+        std::swap(x, y);
+    }
+    if (symmetry & 1) {
+        x = n - 1 - x;
+    }
+    if (symmetry & 2) {
+        y = n - 1 - y;
+    }
+    return {x, y};
+}
+
+std::pair<int, int> OpeningBook::inverse(int symmetry, std::pair<int, int> pt, int n) {
+    auto [x, y] = pt;
+    if (symmetry & 1) {
+        x = n - 1 - x;
+    }
+    if (symmetry & 2) {
+        y = n - 1 - y;
+    }
+    if (symmetry & 4) {
+        std::swap(x, y);
+    }
+    return {x, y};
+}
+
+void OpeningBook::write(const std::string& path, int board_size, std::vector<Entry> book_entries) {
+    std::sort(book_entries.begin(), book_entries.end(), [](const Entry& a, const Entry& b) {
+        return a.key != b.key ? a.key < b.key : a.depth > b.depth;
+    });
+    book_entries.erase(std::unique(book_entries.begin(), book_entries.end(),
+                                   [](const Entry& a, const Entry& b) { return a.key == b.key; }),
+                       book_entries.end());
+
+    Header header = {};
+    std::memcpy(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    header.board_size = static_cast<uint32_t>(board_size);
+    header.count = book_entries.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(book_entries.data()), book_entries.size() * sizeof(Entry));
+    if (!out) {
+        throw std::runtime_error("[Error] Failed to write opening book " + path);
+    }
+}
@@ -0,0 +1,170 @@
+#include "PatternWeights.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+static const char WEIGHTS_MAGIC[8] = {'G', 'M', 'K', 'E', 'V', 'A', 'L', '1'};
+
+static_assert(sizeof(PatternWeights::Header) == 16, "weights header layout");
+static_assert(PatternWeights::mirror(PatternWeights::mirror(123)) == 123, "mirror is an involution");
+
+// A line segment around a stone: 9 cells, the stone on cell 4, each cell 0
+// (empty), 1 (mine) or 2 (blocked). The 8 cells around the stone make a code
+// in base 3, cell 0 weighing 1 and cell 8 weighing 3^7.
+static const int SEGMENT = 9;
+static const int CENTRE = 4;
+static const int SEGMENT_CODES = 6561; // 3^8
+
+static int segment_code(const int segment[SEGMENT]) {
+    int code = 0;
+    for (int i = SEGMENT - 1; i >= 0; i--) {
+        if (i != CENTRE) {
+            code = code * 3 + segment[i];
+        }
+    }
+    return code;
+}
+
+// Five in a row through the centre
+static bool five_through_centre(const int segment[SEGMENT]) {
+    for (int start = 0; start <= CENTRE; start++) {
+        bool five = true;
+        for (int i = start; i < start + 5; i++) {
+            five = five && segment[i] == 1;
+        }
+        if (five) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int segment_level(int segment[SEGMENT], std::array<int8_t, SEGMENT_CODES>& memo) {
+    int code = segment_code(segment);
+    if (memo[code] >= 0) {
+        return memo[code];
+    }
+
+    int level = PatternWeights::NONE;
+    if (five_through_centre(segment)) {
+        level = PatternWeights::FIVE;
+    } else {
+        // Cells completing a five make a four; one more stone anywhere raises a three or two to them
+        int completions = 0;
+        int best = PatternWeights::NONE;
+        for (int i = 0; i < SEGMENT; i++) {
+            if (segment[i] != 0) {
+                continue;
+            }
+            segment[i] = 1;
+            if (five_through_centre(segment)) {
+                completions++;
+            } else {
+                switch (segment_level(segment, memo)) {
+                    case PatternWeights::FLEX4: best = std::max<int>(best, PatternWeights::FLEX3); break;
+                    case PatternWeights::FOUR:  best = std::max<int>(best, PatternWeights::THREE); break;
+                    case PatternWeights::FLEX3: best = std::max<int>(best, PatternWeights::FLEX2); break;
+                    case PatternWeights::THREE: best = std::max<int>(best, PatternWeights::TWO); break;
+                    default: break;
+                }
+            }
+            segment[i] = 0;
+        }
+        level = completions >= 2 ? PatternWeights::FLEX4 : completions == 1 ? PatternWeights::FOUR : best;
+    }
+    memo[code] = static_cast<int8_t>(level);
+    return level;
+}
+
+static std::array<uint8_t, SEGMENT_CODES> make_level_table() {
+    std::array<int8_t, SEGMENT_CODES> memo;
+    memo.fill(-1);
+    std::array<uint8_t, SEGMENT_CODES> table{};
+    for (int code = 0; code < SEGMENT_CODES; code++) {
+        int segment[SEGMENT];
+        for (int i = 0, rest = code; i < SEGMENT; i++) {
+            if (i == CENTRE) {
+                segment[i] = 1;
+            } else {
+                segment[i] = rest % 3;
+                rest /= 3;
+            }
+        }
+        table[code] = static_cast<uint8_t>(segment_level(segment, memo));
+    }
+    return table;
+}
+
+// Base-3 value of an 8-bit mask
+static constexpr std::array<int, 256> make_base3_8() {
+    std::array<int, 256> table{};
+    for (int mask = 0; mask < 256; mask++) {
+        for (int i = 7, value = 0; i >= 0; i--) {
+            value = value * 3 + ((mask >> i) & 1);
+            table[mask] = value;
+        }
+    }
+    return table;
+}
+
+static const std::array<uint8_t, SEGMENT_CODES> LEVEL_TABLE = make_level_table();
+static constexpr std::array<int, 256> BASE3_8 = make_base3_8();
+
+int PatternWeights::level(uint32_t mine, uint32_t blocked) {
+    // Drop the centre bit; cells 5-8 move down to bits 4-7
+    uint32_t m = (mine & 0xF) | ((mine >> 1) & 0xF0);
+    uint32_t b = (blocked & 0xF) | ((blocked >> 1) & 0xF0);
+    return LEVEL_TABLE[BASE3_8[m] + 2 * BASE3_8[b]];
+}
+
+int PatternWeights::cell_pattern(const uint8_t levels[4]) {
+    int first = NONE;
+    int second = NONE;
+    for (int dir = 0; dir < 4; dir++) {
+        if (levels[dir] > first) {
+            second = first;
+            first = levels[dir];
+        } else if (levels[dir] > second) {
+            second = levels[dir];
+        }
+    }
+    return first * LEVELS + second;
+}
+
+bool PatternWeights::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    Header header;
+    std::array<int16_t, LINE_PATTERNS> read_lines;
+    std::array<int16_t, CELL_PATTERNS> read_cells;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    in.read(reinterpret_cast<char*>(read_lines.data()), sizeof(read_lines));
+    in.read(reinterpret_cast<char*>(read_cells.data()), sizeof(read_cells));
+    if (!in || in.peek() != std::ifstream::traits_type::eof() ||
+        std::memcmp(header.magic, WEIGHTS_MAGIC, sizeof(WEIGHTS_MAGIC)) != 0 ||
+        header.line_patterns != LINE_PATTERNS || header.cell_patterns != CELL_PATTERNS) {
+        throw std::runtime_error("[Error] " + path + " is not a valid evaluation weight file");
+    }
+    lines = read_lines;
+    cells = read_cells;
+    return true;
+}
+
+void PatternWeights::save(const std::string& path) const {
+    Header header = {};
+    std::memcpy(header.magic, WEIGHTS_MAGIC, sizeof(WEIGHTS_MAGIC));
+    header.line_patterns = LINE_PATTERNS;
+    header.cell_patterns = CELL_PATTERNS;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(lines.data()), sizeof(lines));
+    out.write(reinterpret_cast<const char*>(cells.data()), sizeof(cells));
+    if (!out) {
+        throw std::runtime_error("[Error] Failed to write evaluation weights " + path);
+    }
+}
@@ -0,0 +1,36 @@
+#include "SearchEngine.hpp"
+#include "MinimaxAlgorithm.hpp"
+#include "MctsAlgorithm.hpp"
+#include <stdexcept>
+
+static std::invalid_argument unsupported_size(std::pair<int, int> board_size) {
+    return std::invalid_argument("[Error] No search engine for a " + std::to_string(board_size.first) + "x" +
+                                 std::to_string(board_size.second) + " board (built: 9x9, 15x15, 19x19)");
+}
+
+bool search_engine_supports(int columns, int rows) {
+    return columns == rows && (columns == 9 || columns == 15 || columns == 19);
+}
+
+std::unique_ptr<SearchEngine> make_search_engine(std::pair<int, int> board_size, int search_depth,
+                                                 double attack_ratio, std::shared_ptr<TranspositionTable> table) {
+    if (board_size.first == board_size.second) {
+        switch (board_size.first) {
+            case 9:  return std::make_unique<MinimaxAlgorithm<9, 9>>(search_depth, attack_ratio, std::move(table));
+            case 15: return std::make_unique<MinimaxAlgorithm<15, 15>>(search_depth, attack_ratio, std::move(table));
+            case 19: return std::make_unique<MinimaxAlgorithm<19, 19>>(search_depth, attack_ratio, std::move(table));
+        }
+    }
+    throw unsupported_size(board_size);
+}
+
+std::unique_ptr<SearchEngine> make_mcts_engine(std::pair<int, int> board_size, int playouts, double attack_ratio) {
+    if (board_size.first == board_size.second) {
+        switch (board_size.first) {
+            case 9:  return std::make_unique<MctsAlgorithm<9, 9>>(playouts, attack_ratio);
+            case 15: return std::make_unique<MctsAlgorithm<15, 15>>(playouts, attack_ratio);
+            case 19: return std::make_unique<MctsAlgorithm<19, 19>>(playouts, attack_ratio);
+        }
+    }
+    throw unsupported_size(board_size);
+}
@@ -0,0 +1,146 @@
+#include "ShapeEvaluator.hpp"
+#include "ShapeTable.hpp"
+#include <algorithm>
+
+template <int COLUMNS, int ROWS>
+void ShapeEvaluator<COLUMNS, ROWS>::reset(const Board& board) {
+    total[0] = total[1] = 0;
+    for (int side = 0; side < 2; side++) {
+        line_score[side].fill(0);
+        for (int dir = 0; dir < Board::DIRECTIONS; dir++) {
+            cover[side][dir].fill(0);
+        }
+        cell_bonus[side].fill(0);
+    }
+
+    for (int line = 0; line < board.line_count(); line++) {
+        rescore_line(board, line, 0);
+        rescore_line(board, line, 1);
+    }
+}
+
+template <int COLUMNS, int ROWS>
+void ShapeEvaluator<COLUMNS, ROWS>::update(const Board& board, int x, int y) {
+    for (int dir = 0; dir < Board::DIRECTIONS; dir++) {
+        int line = board.line_of(dir, x, y);
+        rescore_line(board, line, 0);
+        rescore_line(board, line, 1);
+    }
+}
+
+// Best shape score of the 6-cell window starting at bit start, 0 if none matches.
+// Cells off the line read as empty, as they did in the list-based evaluation.
+template <int COLUMNS, int ROWS>
+int ShapeEvaluator<COLUMNS, ROWS>::best_shape(uint32_t mine, uint32_t enemy, int start) const {
+    if (start < 0) {
+        return shape_table::window_score(mine << -start, enemy << -start);
+    }
+    return shape_table::window_score(mine >> start, enemy >> start);
+}
+
+template <int COLUMNS, int ROWS>
+int ShapeEvaluator<COLUMNS, ROWS>::cross_bonus(int side, int cell) const {
+    int bonus = 0;
+    for (int d1 = 0; d1 < Board::DIRECTIONS; d1++) {
+        for (int d2 = d1 + 1; d2 < Board::DIRECTIONS; d2++) {
+            int s1 = cover[side][d1][cell];
+            int s2 = cover[side][d2][cell];
+            if (s1 > 10 && s2 > 10) {
+                bonus += s1 + s2;
+            }
+        }
+    }
+    return bonus;
+}
+
+template <int COLUMNS, int ROWS>
+void ShapeEvaluator<COLUMNS, ROWS>::rescore_line(const Board& board, int line, int side) {
+    int dir = board.line_direction(line);
+    auto [lo, hi] = board.line_span(line);
+
+    // Drop what this line contributed before
+    total[side] -= line_score[side][line];
+    for (int bit = lo; bit <= hi; bit++) {
+        auto [x, y] = board.cell_at(line, bit);
+        int cell = x * ROW + y;
+        total[side] -= cell_bonus[side][cell];
+        cell_bonus[side][cell] = 0;
+        cover[side][dir][cell] = 0;
+    }
+
+    uint32_t mine = board.line_mask(line, side);
+    uint32_t enemy = board.line_mask(line, 1 - side);
+
+    // Scan stones along the line; a stone already inside a counted shape is skipped
+    int shape_start[Board::MAX_LINE];
+    int shape_value[Board::MAX_LINE];
+    int shape_count = 0;
+    int score = 0;
+
+    for (int bit = lo; bit <= hi; bit++) {
+        if (!((mine >> bit) & 1u)) {
+            continue;
+        }
+
+        bool counted = false;
+        for (int k = 0; k < shape_count; k++) {
+            if (bit >= shape_start[k] && bit <= shape_start[k] + 4) {
+                counted = true;
+                break;
+            }
+        }
+        if (counted) {
+            continue;
+        }
+
+        int best = 0;
+        int best_start = 0;
+        for (int offset = -5; offset < 1; offset++) {
+            int value = best_shape(mine, enemy, bit + offset);
+            if (value > best) {
+                best = value;
+                best_start = bit + offset;
+            }
+        }
+        if (best == 0) {
+            continue;
+        }
+
+        // Overlapping shapes on the same line score extra
+        int add_score = 0;
+        for (int k = 0; k < shape_count; k++) {
+            int overlap = std::min(shape_start[k], best_start) + 5 - std::max(shape_start[k], best_start);
+            if (overlap > 0 && shape_value[k] > 10 && best > 10) {
+                add_score += overlap * (shape_value[k] + best);
+            }
+        }
+
+        shape_start[shape_count] = best_start;
+        shape_value[shape_count] = best;
+        shape_count++;
+        score += add_score + best;
+
+        for (int i = 0; i < 5; i++) {
+            auto [x, y] = board.cell_at(line, best_start + i);
+            if (board.in_bounds(x, y)) {
+                int& c = cover[side][dir][x * ROW + y];
+                c = std::max(c, best);
+            }
+        }
+    }
+
+    line_score[side][line] = score;
+    total[side] += score;
+
+    // Shapes crossing other directions on this line
+    for (int bit = lo; bit <= hi; bit++) {
+        auto [x, y] = board.cell_at(line, bit);
+        int cell = x * ROW + y;
+        cell_bonus[side][cell] = cross_bonus(side, cell);
+        total[side] += cell_bonus[side][cell];
+    }
+}
+
+template class ShapeEvaluator<9, 9>;
+template class ShapeEvaluator<15, 15>;
+template class ShapeEvaluator<19, 19>;
@@ -0,0 +1,310 @@
+#include "ThreatSearch.hpp"
+#include <algorithm>
+#include <bit>
+
+template <int COLUMNS, int ROWS>
+ThreatSearch<COLUMNS, ROWS>::ThreatSearch()
+    : node_count(0), node_limit(20000), stop_check(nullptr), stop_context(nullptr), stop(false) {}
+
+// Clear the counters; false if the stop check already says no
+template <int COLUMNS, int ROWS>
+bool ThreatSearch<COLUMNS, ROWS>::start_search() {
+    node_count = 0;
+    stop = stop_check && stop_check(stop_context);
+    return !stop;
+}
+
+template <int COLUMNS, int ROWS>
+bool ThreatSearch<COLUMNS, ROWS>::count_node() {
+    if (++node_count > node_limit) {
+        return true;
+    }
+    if (stop_check && (node_count & 63) == 0 && !stop) {
+        stop = stop_check(stop_context);
+    }
+    return stop;
+}
+
+template <int COLUMNS, int ROWS>
+bool ThreatSearch<COLUMNS, ROWS>::find_vcf(Board& board, int attacker, int max_depth, std::pair<int, int>& move) {
+    if (!start_search()) {
+        return false;
+    }
+    int cell = -1;
+    if (!vcf(board, attacker, max_depth, cell)) {
+        return false;
+    }
+    move = {cell / ROW, cell % ROW};
+    return true;
+}
+
+template <int COLUMNS, int ROWS>
+bool ThreatSearch<COLUMNS, ROWS>::find_vct(Board& board, int attacker, int max_depth, std::pair<int, int>& move) {
+    if (!start_search()) {
+        return false;
+    }
+    int cell = -1;
+    if (!vct(board, attacker, max_depth, cell)) {
+        return false;
+    }
+    move = {cell / ROW, cell % ROW};
+    return true;
+}
+
+template <int COLUMNS, int ROWS>
+bool ThreatSearch<COLUMNS, ROWS>::vcf(Board& board, int attacker, int depth, int& move) {
+    if (count_node()) {
+        return false;
+    }
+
+    int win = board.five_point(attacker);
+    if (win >= 0) {
+        move = win;
+        return true;
+    }
+
+    // A four of the defender has to be blocked first, which ends the sequence
+    if (depth == 0 || board.five_point(1 - attacker) >= 0) {
+        return false;
+    }
+
+    MoveList<CELLS> fours;
+    window_moves(board, attacker, 3, fours);
+    for (int cell : fours) {
+        if (try_four(board, attacker, cell, depth, false)) {
+            move = cell;
+            return true;
+        }
+        if (given_up()) {
+            return false;
+        }
+    }
+    return false;
+}
+
+template <int COLUMNS, int ROWS>
+bool ThreatSearch<COLUMNS, ROWS>::vct(Board& board, int attacker, int depth, int& move) {
+    if (count_node()) {
+        return false;
+    }
+
+    int win = board.five_point(attacker);
+    if (win >= 0) {
+        move = win;
+        return true;
+    }
+    if (depth == 0 || board.five_point(1 - attacker) >= 0) {
+        return false;
+    }
+
+    // Fours first: they leave the defender a single reply
+    MoveList<CELLS> fours;
+    window_moves(board, attacker, 3, fours);
+    for (int cell : fours) {
+        if (try_four(board, attacker, cell, depth, true)) {
+            move = cell;
+            return true;
+        }
+        if (given_up()) {
+            return false;
+        }
+    }
+
+    // A three is only forcing while the defender has no four to answer with
+    int defender = 1 - attacker;
+    if (can_make_four(board, defender)) {
+        return false;
+    }
+
+    MoveList<CELLS> threes;
+    window_moves(board, attacker, 2, threes);
+    for (int cell : threes) {
+        if (std::binary_search(fours.begin(), fours.end(), cell)) {
+            continue;
+        }
+
+        int x = cell / ROW;
+        int y = cell % ROW;
+        board.place(x, y, attacker);
+        bool refuted_all = open_four_point_through(board, attacker, x, y);
+
+        // Every defence on the lines of the three has to lose as well
+        for (int dir = 0; dir < Board::DIRECTIONS && refuted_all; dir++) {
+            int line = board.line_of(dir, x, y);
+            int bit = board.bit_of(dir, x, y);
+            auto [lo, hi] = board.line_span(line);
+
+            for (int e = std::max(lo, bit - 5); e <= std::min(hi, bit + 5) && refuted_all; e++) {
+                auto [dx, dy] = board.cell_at(line, e);
+                if (!board.is_empty(dx, dy)) {
+                    continue;
+                }
+
+                board.place(dx, dy, defender);
+                bool attacker_wins = open_four_point_through(board, attacker, x, y) &&
+                                     board.five_point(defender) < 0;
+                if (!attacker_wins) {
+                    int reply;
+                    attacker_wins = vct(board, attacker, depth - 1, reply);
+                }
+                board.remove(dx, dy, defender);
+
+                refuted_all = attacker_wins;
+            }
+        }
+        board.remove(x, y, attacker);
+
+        if (refuted_all) {
+            move = cell;
+            return true;
+        }
+        if (given_up()) {
+            return false;
+        }
+    }
+    return false;
+}
+
+template <int COLUMNS, int ROWS>
+bool ThreatSearch<COLUMNS, ROWS>::try_four(Board& board, int attacker, int cell, int depth, bool with_threes) {
+    int x = cell / ROW;
+    int y = cell % ROW;
+    int defender = 1 - attacker;
+
+    board.place(x, y, attacker);
+    int points[4 * Board::DIRECTIONS];
+    int count = five_points_through(board, attacker, x, y, points);
+
+    // Two ways to five cannot both be blocked
+    bool win = count >= 2;
+    if (count == 1) {
+        int bx = points[0] / ROW;
+        int by = points[0] % ROW;
+        board.place(bx, by, defender);
+        if (!board.has_five(defender)) {
+            int reply;
+            win = with_threes ? vct(board, attacker, depth - 1, reply)
+                              : vcf(board, attacker, depth - 1, reply);
+        }
+        board.remove(bx, by, defender);
+    }
+    board.remove(x, y, attacker);
+    return win;
+}
+
+template <int COLUMNS, int ROWS>
+int ThreatSearch<COLUMNS, ROWS>::five_points_through(const Board& board, int side, int x, int y, int out[]) const {
+    int count = 0;
+    for (int dir = 0; dir < Board::DIRECTIONS; dir++) {
+        int line = board.line_of(dir, x, y);
+        int bit = board.bit_of(dir, x, y);
+        uint32_t mine = board.line_mask(line, side);
+        uint32_t enemy = board.line_mask(line, 1 - side);
+        auto [lo, hi] = board.line_span(line);
+
+        uint32_t points = 0;
+        for (int s = std::max(lo, bit - 4); s <= std::min(hi - 4, bit); s++) {
+            uint32_t window = 0x1Fu << s;
+            if (!(enemy & window) && std::popcount(mine & window) == 4) {
+                points |= window & ~mine;
+            }
+        }
+
+        while (points) {
+            auto [px, py] = board.cell_at(line, std::countr_zero(points));
+            out[count++] = px * ROW + py;
+            points &= points - 1;
+        }
+    }
+    return count;
+}
+
+template <int COLUMNS, int ROWS>
+bool ThreatSearch<COLUMNS, ROWS>::open_four_point_through(const Board& board, int side, int x, int y) const {
+    for (int dir = 0; dir < Board::DIRECTIONS; dir++) {
+        int line = board.line_of(dir, x, y);
+        int bit = board.bit_of(dir, x, y);
+        uint32_t mine = board.line_mask(line, side);
+        uint32_t enemy = board.line_mask(line, 1 - side);
+        auto [lo, hi] = board.line_span(line);
+
+        for (int e = std::max(lo, bit - 4); e <= std::min(hi, bit + 4); e++) {
+            if (((mine | enemy) >> e) & 1u) {
+                continue;
+            }
+
+            // Stone on e: count the ways to five it opens on this line
+            uint32_t with_e = mine | (1u << e);
+            uint32_t points = 0;
+            for (int s = std::max(lo, e - 4); s <= std::min(hi - 4, e); s++) {
+                uint32_t window = 0x1Fu << s;
+                if (!(enemy & window) && std::popcount(with_e & window) == 4) {
+                    points |= window & ~with_e;
+                }
+            }
+            if (std::popcount(points) >= 2) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <int COLUMNS, int ROWS>
+void ThreatSearch<COLUMNS, ROWS>::window_moves(const Board& board, int side, int stones, MoveList<CELLS>& out) const {
+    // Mark cells first: windows overlap, and the bit order gives board order for free
+    uint64_t marked[(CELLS + 63) / 64] = {};
+    for (int line = 0; line < board.line_count(); line++) {
+        uint32_t mine = board.line_mask(line, side);
+        if (std::popcount(mine) < stones) {
+            continue;
+        }
+        uint32_t enemy = board.line_mask(line, 1 - side);
+        auto [lo, hi] = board.line_span(line);
+
+        for (int s = lo; s <= hi - 4; s++) {
+            uint32_t window = 0x1Fu << s;
+            if ((enemy & window) || std::popcount(mine & window) != stones) {
+                continue;
+            }
+            uint32_t empty = window & ~mine;
+            while (empty) {
+                auto [x, y] = board.cell_at(line, std::countr_zero(empty));
+                int cell = x * ROW + y;
+                marked[cell / 64] |= 1ull << (cell % 64);
+                empty &= empty - 1;
+            }
+        }
+    }
+
+    out.clear();
+    for (int word = 0; word < (CELLS + 63) / 64; word++) {
+        for (uint64_t bits = marked[word]; bits; bits &= bits - 1) {
+            out.push_back(word * 64 + std::countr_zero(bits));
+        }
+    }
+}
+
+template <int COLUMNS, int ROWS>
+bool ThreatSearch<COLUMNS, ROWS>::can_make_four(const Board& board, int side) const {
+    for (int line = 0; line < board.line_count(); line++) {
+        uint32_t mine = board.line_mask(line, side);
+        if (std::popcount(mine) < 3) {
+            continue;
+        }
+        uint32_t enemy = board.line_mask(line, 1 - side);
+        auto [lo, hi] = board.line_span(line);
+
+        for (int s = lo; s <= hi - 4; s++) {
+            uint32_t window = 0x1Fu << s;
+            if (!(enemy & window) && std::popcount(mine & window) == 3) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template class ThreatSearch<9, 9>;
+template class ThreatSearch<15, 15>;
+template class ThreatSearch<19, 19>;
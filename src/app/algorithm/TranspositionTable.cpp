@@ -0,0 +1,80 @@
+#include "TranspositionTable.hpp"
+#include <algorithm>
+
+TranspositionTable::TranspositionTable(std::size_t megabytes) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(std::size_t megabytes) {
+    std::size_t bytes = std::max<std::size_t>(megabytes, 1) << 20;
+    std::size_t entries = 1;
+    while (entries * 2 * sizeof(Slot) <= bytes) {
+        entries *= 2;
+    }
+
+    table.reset(new Slot[entries]);
+    mask = entries - 1;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (uint64_t i = 0; i <= mask; i++) {
+        table[i].check.store(0, std::memory_order_relaxed);
+        table[i].data.store(0, std::memory_order_relaxed);
+    }
+    generation = 0;
+}
+
+// Layout: score (32) | move (16) | depth (8) | bound (2) | age (6)
+uint64_t TranspositionTable::pack(const Entry& entry, uint8_t age) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(entry.score))
+         | static_cast<uint64_t>(static_cast<uint16_t>(entry.move)) << 32
+         | static_cast<uint64_t>(static_cast<uint8_t>(entry.depth)) << 48
+         | static_cast<uint64_t>(entry.bound & 0x3) << 56
+         | static_cast<uint64_t>(age & 0x3F) << 58;
+}
+
+TranspositionTable::Entry TranspositionTable::unpack(uint64_t data) {
+    return Entry{
+        static_cast<int32_t>(static_cast<uint32_t>(data)),
+        static_cast<int16_t>(static_cast<uint16_t>(data >> 32)),
+        static_cast<int8_t>(static_cast<uint8_t>(data >> 48)),
+        static_cast<Bound>((data >> 56) & 0x3)
+    };
+}
+
+TranspositionTable::ProbeResult TranspositionTable::probe(uint64_t key, Entry& out) const {
+    const Slot& slot = table[key & mask];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+    Entry entry = unpack(data);
+    if (entry.bound == NONE) {
+        return MISS;
+    }
+    if ((check ^ data) != key) {
+        return COLLISION;
+    }
+    out = entry;
+    return HIT;
+}
+
+void TranspositionTable::store(uint64_t key, int depth, Bound bound, int score, int move) {
+    Slot& slot = table[key & mask];
+    uint64_t old_data = slot.data.load(std::memory_order_relaxed);
+    bool same_key = (slot.check.load(std::memory_order_relaxed) ^ old_data) == key;
+    Entry old = unpack(old_data);
+
+    if (old.bound != NONE && !same_key && age_of(old_data) == generation && old.depth > depth) {
+        return;
+    }
+
+    // Keep the old best move when the new result has none
+    if (move < 0 && same_key) {
+        move = old.move;
+    }
+
+    uint64_t data = pack(Entry{score, static_cast<int16_t>(move), static_cast<int8_t>(depth), bound}, generation);
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+}
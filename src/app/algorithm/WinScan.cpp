@@ -0,0 +1,256 @@
+#include "WinScan.hpp"
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define WIN_SCAN_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define WIN_SCAN_NEON 1
+#endif
+
+namespace win_scan {
+
+// ---- Scalar ----
+
+static bool any_five_scalar(const uint32_t* lines, int count) {
+    for (int i = 0; i < count; i++) {
+        uint32_t m = lines[i];
+        if (m & (m >> 1) & (m >> 2) & (m >> 3) & (m >> 4)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int first_four_scalar(const uint32_t* mine, const uint32_t* enemy, const uint32_t* outside,
+                             int count, int from) {
+    for (int i = from; i < count; i++) {
+        if (four_windows(mine[i], enemy[i] | outside[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// ---- SSE2 / AVX2 ----
+
+#ifdef WIN_SCAN_X86
+
+__attribute__((target("sse2")))
+static bool any_five_sse2(const uint32_t* lines, int count) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lines + i));
+        __m128i r = _mm_and_si128(_mm_and_si128(m, _mm_srli_epi32(m, 1)),
+                                  _mm_and_si128(_mm_srli_epi32(m, 2), _mm_srli_epi32(m, 3)));
+        r = _mm_and_si128(r, _mm_srli_epi32(m, 4));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(r, _mm_setzero_si128())) != 0xFFFF) {
+            return true;
+        }
+    }
+    return any_five_scalar(lines + i, count - i);
+}
+
+__attribute__((target("sse2")))
+static int first_four_sse2(const uint32_t* mine, const uint32_t* enemy, const uint32_t* outside,
+                           int count, int from) {
+    const __m128i limit = _mm_set1_epi32(static_cast<int>(~0u >> 4));
+    int i = from;
+    for (; i + 4 <= count; i += 4) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mine + i));
+        __m128i blocked = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(enemy + i)),
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(outside + i)));
+        __m128i b = _mm_srli_epi32(a, 1), c = _mm_srli_epi32(a, 2);
+        __m128i d = _mm_srli_epi32(a, 3), e = _mm_srli_epi32(a, 4);
+
+        __m128i all4 = _mm_and_si128(_mm_and_si128(a, b), _mm_and_si128(c, d));
+        __m128i three = _mm_or_si128(_mm_and_si128(_mm_and_si128(a, b), _mm_or_si128(c, d)),
+                                     _mm_and_si128(_mm_and_si128(c, d), _mm_or_si128(a, b)));
+        __m128i at_least4 = _mm_or_si128(all4, _mm_and_si128(e, three));
+        __m128i five = _mm_and_si128(all4, e);
+        __m128i blocked_window = _mm_or_si128(_mm_or_si128(blocked, _mm_srli_epi32(blocked, 1)),
+                                              _mm_or_si128(_mm_srli_epi32(blocked, 2), _mm_srli_epi32(blocked, 3)));
+        blocked_window = _mm_or_si128(blocked_window, _mm_srli_epi32(blocked, 4));
+
+        __m128i r = _mm_andnot_si128(_mm_or_si128(five, blocked_window), _mm_and_si128(at_least4, limit));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(r, _mm_setzero_si128())) != 0xFFFF) {
+            return first_four_scalar(mine, enemy, outside, i + 4, i);
+        }
+    }
+    return first_four_scalar(mine, enemy, outside, count, i);
+}
+
+__attribute__((target("avx2")))
+static bool any_five_avx2(const uint32_t* lines, int count) {
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lines + i));
+        __m256i r = _mm256_and_si256(_mm256_and_si256(m, _mm256_srli_epi32(m, 1)),
+                                     _mm256_and_si256(_mm256_srli_epi32(m, 2), _mm256_srli_epi32(m, 3)));
+        r = _mm256_and_si256(r, _mm256_srli_epi32(m, 4));
+        if (!_mm256_testz_si256(r, r)) {
+            return true;
+        }
+    }
+    return any_five_sse2(lines + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static int first_four_avx2(const uint32_t* mine, const uint32_t* enemy, const uint32_t* outside,
+                           int count, int from) {
+    const __m256i limit = _mm256_set1_epi32(static_cast<int>(~0u >> 4));
+    int i = from;
+    for (; i + 8 <= count; i += 8) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mine + i));
+        __m256i blocked = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(enemy + i)),
+                                          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(outside + i)));
+        __m256i b = _mm256_srli_epi32(a, 1), c = _mm256_srli_epi32(a, 2);
+        __m256i d = _mm256_srli_epi32(a, 3), e = _mm256_srli_epi32(a, 4);
+
+        __m256i all4 = _mm256_and_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, d));
+        __m256i three = _mm256_or_si256(_mm256_and_si256(_mm256_and_si256(a, b), _mm256_or_si256(c, d)),
+                                        _mm256_and_si256(_mm256_and_si256(c, d), _mm256_or_si256(a, b)));
+        __m256i at_least4 = _mm256_or_si256(all4, _mm256_and_si256(e, three));
+        __m256i five = _mm256_and_si256(all4, e);
+        __m256i blocked_window = _mm256_or_si256(_mm256_or_si256(blocked, _mm256_srli_epi32(blocked, 1)),
+                                                 _mm256_or_si256(_mm256_srli_epi32(blocked, 2), _mm256_srli_epi32(blocked, 3)));
+        blocked_window = _mm256_or_si256(blocked_window, _mm256_srli_epi32(blocked, 4));
+
+        __m256i r = _mm256_andnot_si256(_mm256_or_si256(five, blocked_window), _mm256_and_si256(at_least4, limit));
+        if (!_mm256_testz_si256(r, r)) {
+            return first_four_scalar(mine, enemy, outside, i + 8, i);
+        }
+    }
+    return first_four_sse2(mine, enemy, outside, count, i);
+}
+
+#endif // WIN_SCAN_X86
+
+// ---- NEON ----
+
+#ifdef WIN_SCAN_NEON
+
+static bool any_five_neon(const uint32_t* lines, int count) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint32x4_t m = vld1q_u32(lines + i);
+        uint32x4_t r = vandq_u32(vandq_u32(m, vshrq_n_u32(m, 1)), vandq_u32(vshrq_n_u32(m, 2), vshrq_n_u32(m, 3)));
+        r = vandq_u32(r, vshrq_n_u32(m, 4));
+        if (vmaxvq_u32(r) != 0) {
+            return true;
+        }
+    }
+    return any_five_scalar(lines + i, count - i);
+}
+
+static int first_four_neon(const uint32_t* mine, const uint32_t* enemy, const uint32_t* outside,
+                           int count, int from) {
+    const uint32x4_t limit = vdupq_n_u32(~0u >> 4);
+    int i = from;
+    for (; i + 4 <= count; i += 4) {
+        uint32x4_t a = vld1q_u32(mine + i);
+        uint32x4_t blocked = vorrq_u32(vld1q_u32(enemy + i), vld1q_u32(outside + i));
+        uint32x4_t b = vshrq_n_u32(a, 1), c = vshrq_n_u32(a, 2);
+        uint32x4_t d = vshrq_n_u32(a, 3), e = vshrq_n_u32(a, 4);
+
+        uint32x4_t all4 = vandq_u32(vandq_u32(a, b), vandq_u32(c, d));
+        uint32x4_t three = vorrq_u32(vandq_u32(vandq_u32(a, b), vorrq_u32(c, d)),
+                                     vandq_u32(vandq_u32(c, d), vorrq_u32(a, b)));
+        uint32x4_t at_least4 = vorrq_u32(all4, vandq_u32(e, three));
+        uint32x4_t five = vandq_u32(all4, e);
+        uint32x4_t blocked_window = vorrq_u32(vorrq_u32(blocked, vshrq_n_u32(blocked, 1)),
+                                              vorrq_u32(vshrq_n_u32(blocked, 2), vshrq_n_u32(blocked, 3)));
+        blocked_window = vorrq_u32(blocked_window, vshrq_n_u32(blocked, 4));
+
+        uint32x4_t r = vbicq_u32(vandq_u32(at_least4, limit), vorrq_u32(five, blocked_window));
+        if (vmaxvq_u32(r) != 0) {
+            return first_four_scalar(mine, enemy, outside, i + 4, i);
+        }
+    }
+    return first_four_scalar(mine, enemy, outside, count, i);
+}
+
+#endif // WIN_SCAN_NEON
+
+// ---- Dispatch ----
+
+struct Kernels {
+    Impl impl;
+    bool (*any_five)(const uint32_t*, int);
+    int (*first_four)(const uint32_t*, const uint32_t*, const uint32_t*, int, int);
+};
+
+static Kernels kernels_for(Impl impl) {
+    switch (impl) {
+#ifdef WIN_SCAN_X86
+        case Impl::AVX2: return {Impl::AVX2, any_five_avx2, first_four_avx2};
+        case Impl::SSE2: return {Impl::SSE2, any_five_sse2, first_four_sse2};
+#endif
+#ifdef WIN_SCAN_NEON
+        case Impl::NEON: return {Impl::NEON, any_five_neon, first_four_neon};
+#endif
+        default:         return {Impl::Scalar, any_five_scalar, first_four_scalar};
+    }
+}
+
+bool available(Impl impl) {
+#ifdef WIN_SCAN_X86
+    // May run during static initialisation, before CPU detection would otherwise run
+    __builtin_cpu_init();
+#endif
+    switch (impl) {
+        case Impl::Scalar: return true;
+#ifdef WIN_SCAN_X86
+        case Impl::SSE2:   return __builtin_cpu_supports("sse2");
+        case Impl::AVX2:   return __builtin_cpu_supports("avx2");
+#endif
+#ifdef WIN_SCAN_NEON
+        case Impl::NEON:   return true;
+#endif
+        default:           return false;
+    }
+}
+
+Impl best_available() {
+    for (Impl impl : {Impl::AVX2, Impl::NEON, Impl::SSE2}) {
+        if (available(impl)) {
+            return impl;
+        }
+    }
+    return Impl::Scalar;
+}
+
+// Function-local, so it is set up on first use even when that use comes
+// from the static initialiser of another translation unit
+static Kernels& active() {
+    static Kernels kernels = kernels_for(best_available());
+    return kernels;
+}
+
+void select(Impl impl) {
+    active() = kernels_for(available(impl) ? impl : Impl::Scalar);
+}
+
+Impl selected() {
+    return active().impl;
+}
+
+const char* name(Impl impl) {
+    switch (impl) {
+        case Impl::SSE2: return "sse2";
+        case Impl::AVX2: return "avx2";
+        case Impl::NEON: return "neon";
+        default:         return "scalar";
+    }
+}
+
+bool any_five(const uint32_t* lines, int count) {
+    return active().any_five(lines, count);
+}
+
+int first_four(const uint32_t* mine, const uint32_t* enemy, const uint32_t* outside, int count, int from) {
+    return active().first_four(mine, enemy, outside, count, from);
+}
+
+} // namespace win_scan
@@ -5,16 +5,48 @@
 GomokuCoordinator::GomokuCoordinator(GomokuAI &ai, int ai_player, ArmController *arm)
     : ai(ai), ai_player(ai_player), human_player(3 - ai_player), armController(arm) {}
 
+GomokuCoordinator::~GomokuCoordinator()
+{
+    std::thread previous;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        generation++;
+        ai.cancelSearch();
+        previous = std::move(mover);
+    }
+    if (previous.joinable())
+        previous.join();
+}
+
 void GomokuCoordinator::onNewPieceDetected(int row, int col, const std::string &color)
 {
     int player = (color == "black") ? 1 : 2;
 
+    // Any search still running was for the board before this piece. Its
+    // mover is joined outside the lock, which it takes to finish.
+    std::thread previous;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        generation++;
+        ai.cancelSearch();
+        previous = std::move(mover);
+    }
+    if (previous.joinable())
+        previous.join();
+
+    std::lock_guard<std::mutex> lock(mutex);
     std::cout << "[Vision] Detected " << color << " piece at (" << row << ", " << col << ")\n";
+    if (ai.isGameOver())
+    {
+        std::cout << "[Game Over] Ignoring piece, the game has ended.\n";
+        return;
+    }
     ai.updateBoard(row, col, player);
 
     if (ai.checkWin(player))
     {
         std::cout << "[Game Over] Player " << color << " wins!\n";
+        ai.stopPondering();
         return;
     }
 
@@ -29,24 +61,48 @@ void GomokuCoordinator::onNewPieceDetected(int row, int col, const std::string &
                         (total_pieces % 2 == 1 && ai_player == 2) );
     if (is_ai_turn)
     {
-        auto [ai_row, ai_col] = ai.getBestMove();
-        std::cout << "[AI] Decided move: (" << ai_row << ", " << ai_col << ")\n";
+        std::cout << "[AI] Thinking...\n";
+        mover = std::thread(&GomokuCoordinator::playMove, this, ai.getBestMoveAsync(), generation);
+    }
+    else
+    {
+        std::cout << "[AI] Not my turn yet.\n";
+    }
+}
+
+// Mover thread: play the AI's move unless a detection made it stale
+void GomokuCoordinator::playMove(std::future<std::pair<int, int>> move, uint64_t search_generation)
+{
+    auto [ai_row, ai_col] = move.get();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (search_generation != generation)
+    {
+        std::cout << "[AI] Search cancelled, the board changed.\n";
+        return;
+    }
+    if (ai_row < 0)
+    {
+        std::cout << "[Game Over] Draw, no legal move left.\n";
+        return;
+    }
+    std::cout << "[AI] Decided move: (" << ai_row << ", " << ai_col << ")\n";
 
-        if (armController)
-        {
-            std::cout << "[ARM] Executing move...\n";
-            armController->enqueueMove(ai_row, ai_col);
-        }
+    if (armController)
+    {
+        std::cout << "[ARM] Executing move...\n";
+        armController->enqueueMove(ai_row, ai_col);
+    }
 
-        ai.updateBoard(ai_row, ai_col, ai_player);
+    ai.updateBoard(ai_row, ai_col, ai_player);
 
-        if (ai.checkWin(ai_player))
-        {
-            std::cout << "[Game Over] AI wins!\n";
-        }
+    if (ai.checkWin(ai_player))
+    {
+        std::cout << "[Game Over] AI wins!\n";
     }
     else
     {
-        std::cout << "[AI] Not my turn yet.\n";
+        // Think about the likely replies while the human does
+        ai.startPondering();
     }
 }
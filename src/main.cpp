@@ -15,6 +15,13 @@
 #define CAMERA_NUM 0
 #define BLACK_PIECE 1
 #define WHITE_PIECE 2
+#define AI_MOVE_TIME_MS 2000 // Search budget per AI move, 0 = fixed depth
+#define AI_THREADS 4 // Search threads, 1 = deterministic single-threaded search
+#define AI_PONDER true // Search the likely replies while the human thinks
+#define AI_ENGINE EngineType::Minimax // Or EngineType::Mcts for Monte Carlo tree search
+#define AI_BEAM_WIDTH 0 // Moves searched per node (twice that at the root), 0 = all
+#define AI_BOOK_PATH "opening_book.bin" // Built by gomoku_book_gen, optional
+#define AI_EVAL_PATH "eval_weights.bin" // Built by gomoku_eval_train, optional
 
 // Create and initialize hardware interfaces
 ArmController &createArmController()
@@ -44,7 +51,32 @@ int main()
     try
     {
         // Initialize ai module
-        GomokuAI ai(LINE_NUM);
+        GomokuAI ai(LINE_NUM, AI_MOVE_TIME_MS, AI_THREADS, AI_PONDER, AI_ENGINE);
+        ai.setBeam(AI_BEAM_WIDTH);
+
+        // Both files are optional: a broken one is reported and played without
+        try
+        {
+            if (ai.loadOpeningBook(AI_BOOK_PATH))
+                std::cout << "[MAIN] Opening book " << AI_BOOK_PATH << " loaded.\n";
+            else
+                std::cout << "[MAIN] No opening book for this board size, searching every move.\n";
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << "\n[MAIN] Ignoring the opening book, searching every move.\n";
+        }
+        try
+        {
+            if (ai.loadEvaluator(AI_EVAL_PATH))
+                std::cout << "[MAIN] Evaluation weights " << AI_EVAL_PATH << " loaded.\n";
+            else
+                std::cout << "[MAIN] No evaluation weights, evaluating by shapes.\n";
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << "\n[MAIN] Ignoring the evaluation weights, evaluating by shapes.\n";
+        }
 
         // Initialize arm module
         ArmController& arm = createArmController();
@@ -0,0 +1,160 @@
+// Offline analysis: best move and score of every position in a file, searched
+// as one batch per board size on all cores, with the throughput at the end.
+//
+// The input has the format of bench/positions.txt, one position per line:
+//   name category board_size ai:<stones> human:<stones>
+// with the AI to move. --repeat searches the file several times in one batch,
+// for throughput measurements on a small file. --warm keeps the transposition
+// tables between positions.
+//
+// Usage: gomoku_analyze <positions> [--depth n] [--time ms] [--threads n]
+//                       [--repeat n] [--warm] [--no-threats]
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "BatchAnalyzer.hpp"
+
+struct Position {
+    std::string name;
+    int size = 0;
+    std::vector<uint8_t> board; // BatchAnalyzer layout
+};
+
+// "ai:1,2;3,4" -> cells (1,2) and (3,4) set to value
+static bool parse_stones(const std::string& field, const std::string& label, uint8_t value, Position& pos) {
+    if (field.compare(0, label.size(), label) != 0) {
+        return false;
+    }
+    std::stringstream list(field.substr(label.size()));
+    std::string stone;
+    while (std::getline(list, stone, ';')) {
+        int x, y;
+        if (std::sscanf(stone.c_str(), "%d,%d", &x, &y) != 2 || x < 0 || x >= pos.size || y < 0 ||
+            y >= pos.size) {
+            return false;
+        }
+        pos.board[x * pos.size + y] = value;
+    }
+    return true;
+}
+
+static std::vector<Position> load_positions(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("[Error] Cannot open positions " + path);
+    }
+
+    std::vector<Position> positions;
+    std::string line;
+    for (int line_no = 1; std::getline(in, line); line_no++) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::stringstream fields(line);
+        std::string category, ai_field, human_field;
+        Position pos;
+        if (!(fields >> pos.name >> category >> pos.size >> ai_field >> human_field)) {
+            throw std::runtime_error("[Error] " + path + ":" + std::to_string(line_no) + ": malformed position");
+        }
+        if (!search_engine_supports(pos.size, pos.size)) {
+            throw std::runtime_error("[Error] " + path + ":" + std::to_string(line_no) + ": unsupported board size");
+        }
+        pos.board.assign(pos.size * pos.size, 0);
+        if (!parse_stones(ai_field, "ai:", 1, pos) || !parse_stones(human_field, "human:", 2, pos)) {
+            throw std::runtime_error("[Error] " + path + ":" + std::to_string(line_no) + ": malformed position");
+        }
+        positions.push_back(pos);
+    }
+    return positions;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <positions> [--depth n] [--time ms] [--threads n] [--repeat n] [--warm] "
+                     "[--no-threats]\n",
+                     argv[0]);
+        return 1;
+    }
+    std::string path = argv[1];
+    int depth = 4;
+    int time_ms = 0;
+    int threads = 0;
+    int repeat = 1;
+    bool warm = false;
+    bool threats = true;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--depth" && i + 1 < argc) {
+            depth = std::atoi(argv[++i]);
+        } else if (arg == "--time" && i + 1 < argc) {
+            time_ms = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::atoi(argv[++i]);
+        } else if (arg == "--warm") {
+            warm = true;
+        } else if (arg == "--no-threats") {
+            threats = false;
+        } else {
+            std::fprintf(stderr, "[Error] unknown argument '%s'\n", arg.c_str());
+            return 1;
+        }
+    }
+    if (depth < 1 || time_ms < 0 || threads < 0 || repeat < 1) {
+        std::fprintf(stderr, "[Error] invalid arguments\n");
+        return 1;
+    }
+
+    try {
+        std::vector<Position> positions = load_positions(path);
+
+        // One contiguous batch per board size, in file order
+        std::map<int, std::vector<std::size_t>> by_size;
+        for (std::size_t p = 0; p < positions.size(); p++) {
+            by_size[positions[p].size].push_back(p);
+        }
+
+        std::size_t total = 0;
+        double total_ms = 0;
+        for (const auto& [size, indices] : by_size) {
+            BatchAnalyzer analyzer({size, size}, depth, threads);
+            analyzer.set_time_limit(time_ms);
+            analyzer.set_threat_search(threats);
+            analyzer.set_warm(warm);
+
+            std::vector<uint8_t> boards;
+            boards.reserve(indices.size() * repeat * size * size);
+            for (int r = 0; r < repeat; r++) {
+                for (std::size_t p : indices) {
+                    boards.insert(boards.end(), positions[p].board.begin(), positions[p].board.end());
+                }
+            }
+
+            std::vector<BatchAnalyzer::Result> results = analyzer.evaluate(boards);
+            for (std::size_t k = 0; k < indices.size(); k++) {
+                const BatchAnalyzer::Result& result = results[k];
+                std::printf("%-20s %2dx%-2d  move %2d,%-2d  score %10d  depth %d\n", positions[indices[k]].name.c_str(),
+                            size, size, result.move.first, result.move.second, result.score, result.depth);
+            }
+            std::printf("%dx%d: %zu positions in %.1f ms on %d threads, %.1f positions/sec\n\n", size, size,
+                        results.size(), analyzer.elapsed_ms(), analyzer.threads(), analyzer.positions_per_second());
+            total += results.size();
+            total_ms += analyzer.elapsed_ms();
+        }
+        std::printf("total: %zu positions, %.1f positions/sec\n", total, total_ms > 0 ? total * 1000.0 / total_ms : 0.0);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
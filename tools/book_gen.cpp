@@ -0,0 +1,106 @@
+// Builds an opening book for GomokuAI by deep search.
+//
+// Starting from the empty board, every position up to `plies` stones is
+// searched with a long time budget and its best move stored. From each
+// position the tree follows the best move and the `branching` most likely
+// other moves, so the book covers both colours and the common replies.
+// Symmetric positions are searched once.
+//
+// Usage: gomoku_book_gen <output> [board_size] [plies] [branching] [move_time_ms]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <set>
+#include <thread>
+#include <vector>
+#include "SearchEngine.hpp"
+#include "OpeningBook.hpp"
+
+using Pieces = OpeningBook::Pieces;
+
+struct Position {
+    Pieces to_move;
+    Pieces other;
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <output> [board_size] [plies] [branching] [move_time_ms]\n", argv[0]);
+        return 1;
+    }
+    std::string output = argv[1];
+    int size = argc > 2 ? std::atoi(argv[2]) : 9;
+    int plies = argc > 3 ? std::atoi(argv[3]) : 4;
+    int branching = argc > 4 ? std::atoi(argv[4]) : 3;
+    int move_time_ms = argc > 5 ? std::atoi(argv[5]) : 10000;
+    if (size < 5 || plies < 1 || branching < 0 || move_time_ms < 1) {
+        std::fprintf(stderr, "[Error] invalid arguments\n");
+        return 1;
+    }
+
+    try {
+        auto minimax = make_search_engine({size, size}, 4, 1.0);
+        minimax->set_time_limit(move_time_ms);
+        minimax->set_threads(std::max(1u, std::thread::hardware_concurrency()));
+        minimax->set_tt_size(256);
+
+        std::vector<OpeningBook::Entry> entries;
+        std::set<uint64_t> seen;
+        std::deque<Position> queue = {Position{}};
+
+        while (!queue.empty()) {
+            Position pos = queue.front();
+            queue.pop_front();
+
+            int symmetry;
+            uint64_t key = OpeningBook::canonical_key(size, pos.to_move, pos.other, symmetry);
+            if (!seen.insert(key).second) {
+                continue;
+            }
+
+            // The search needs a stone to grow candidates from; open in the centre
+            std::pair<int, int> best = {size / 2, size / 2};
+            int depth = 0;
+            if (!pos.to_move.empty() || !pos.other.empty()) {
+                best = minimax->get_next_move(pos.to_move, pos.other);
+                depth = minimax->get_search_stats().depth;
+            }
+
+            auto [cx, cy] = OpeningBook::transform(symmetry, best, size);
+            entries.push_back({key, static_cast<uint16_t>(cx * size + cy), static_cast<uint16_t>(depth), 0});
+
+            int ply = static_cast<int>(pos.to_move.size() + pos.other.size());
+            std::printf("[%zu] ply %d: (%d, %d) depth %d\n", entries.size(), ply, best.first, best.second, depth);
+            std::fflush(stdout);
+
+            if (ply + 1 >= plies) {
+                continue;
+            }
+
+            // The best move and the likeliest alternatives, each handing the turn over
+            std::vector<std::pair<int, int>> moves = {best};
+            if (!pos.to_move.empty() || !pos.other.empty()) {
+                for (const auto& move : minimax->likely_moves(pos.to_move, pos.other, branching + 1)) {
+                    if (move != best && static_cast<int>(moves.size()) <= branching) {
+                        moves.push_back(move);
+                    }
+                }
+            }
+            for (const auto& move : moves) {
+                Position next = {pos.other, pos.to_move};
+                next.other.push_back(move);
+                queue.push_back(next);
+            }
+        }
+
+        OpeningBook::write(output, size, entries);
+        std::printf("Wrote %zu positions to %s\n", entries.size(), output.c_str());
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
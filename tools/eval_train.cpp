@@ -0,0 +1,359 @@
+// Trains the weights of the learned pattern evaluator (LinearEvaluator) and
+// writes them as a weight file for GomokuAI::loadEvaluator() or the eval= key
+// of gomoku_selfplay.
+//
+// Training data comes from self-play: games between two copies of the same
+// engine from random openings, with some moves replaced by one of the likely
+// moves for variety, --games games at each search depth. Every position is
+// labelled with the score the search gave the side to move, squashed to a
+// win probability, so the weights learn what the search sees a few moves
+// ahead (labelling with game results instead plays weaker).
+// The evaluation the search makes of a position, mine - 0.1 * enemy, is
+// linear in the pattern weights, so it is fitted as a logistic regression on
+// the pattern counts, with a line pattern and its mirror image sharing one
+// weight. The weights are then rounded to int16 evaluation units.
+//
+// --init plays the games with the learned evaluator and the given weights, so
+// training can be repeated on games of the previous round; the fit always
+// starts from zero.
+//
+// Usage: gomoku_eval_train <out> [--games n] [--size 9|15|19] [--depths 2,3] [--opening n]
+//                          [--explore p] [--epochs n] [--jobs n] [--seed n] [--init weights]
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "SearchEngine.hpp"
+#include "LinearEvaluator.hpp"
+#include "PatternWeights.hpp"
+
+// Evaluation units per unit of logit: scores come out about the size of shape scores
+static const double EVAL_SCALE = 2000.0;
+// Weight of the enemy score in the search's evaluation at attack ratio 1
+static const double ENEMY_WEIGHT = 0.1;
+// Search score per unit of logit of the label; forced wins and losses are labelled 1 and 0
+static const double SCORE_SCALE = 5000.0;
+static const int WIN_SCORE = 90000000;
+static const double L2 = 1e-6;
+static const double LEARNING_RATE = 0.02; // decayed to 0 along a cosine
+static const int HOLDOUT_EVERY = 10; // every 10th game is kept out of the fit
+static const int EXPLORE_MOVES = 4;  // explored moves are one of this many likely moves
+
+struct Options {
+    int games = 2000; // per depth
+    int size = 15;
+    std::vector<int> depths = {2, 3};
+    int opening = 4;
+    double explore = 0.1;
+    int epochs = 400;
+    int jobs = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    uint64_t seed = 1;
+    std::shared_ptr<const PatternWeights> init;
+};
+
+// One position: mine - ENEMY_WEIGHT * enemy count per shared weight, and the label for the side to move
+struct Sample {
+    std::vector<std::pair<int, float>> features;
+    float label;
+    bool holdout;
+};
+
+// Fitted weights: line patterns, a line pattern and its mirror image sharing
+// the weight of the smaller index, then cell patterns
+static const int FEATURES = PatternWeights::LINE_PATTERNS + PatternWeights::CELL_PATTERNS;
+
+static int canonical(int pattern) {
+    return std::min(pattern, PatternWeights::mirror(pattern));
+}
+
+static float label_of(int score) {
+    if (score >= WIN_SCORE || score <= -WIN_SCORE) {
+        return score > 0 ? 1.0f : 0.0f;
+    }
+    return static_cast<float>(1.0 / (1.0 + std::exp(-score / SCORE_SCALE)));
+}
+
+template <int SIZE>
+static void add_features(const Bitboard<SIZE, SIZE>& board, int to_move, std::vector<float>& counts,
+                         std::vector<int>& touched) {
+    using Linear = LinearEvaluator<SIZE, SIZE>;
+    auto add = [&](int feature, float weight) {
+        if (counts[feature] == 0.0f) {
+            touched.push_back(feature);
+        }
+        counts[feature] += weight;
+    };
+
+    int patterns[Linear::MAX_WINDOWS];
+    for (int side = 0; side < 2; side++) {
+        float weight = side == to_move ? 1.0f : static_cast<float>(-ENEMY_WEIGHT);
+        for (int line = 0; line < board.line_count(); line++) {
+            int count = Linear::line_patterns(board, line, side, patterns);
+            for (int i = 0; i < count; i++) {
+                add(canonical(patterns[i]), weight);
+            }
+        }
+        for (int x = 0; x < SIZE; x++) {
+            for (int y = 0; y < SIZE; y++) {
+                if (board.is_empty(x, y)) {
+                    add(PatternWeights::LINE_PATTERNS + Linear::cell_pattern(board, x, y, side), weight);
+                }
+            }
+        }
+    }
+}
+
+// One self-play game; appends a sample per searched position
+template <int SIZE>
+static void play_game(const Options& options, int game, std::vector<Sample>& samples) {
+    std::mt19937_64 rng(options.seed * 1000003 + game);
+    std::unique_ptr<SearchEngine> engines[2];
+    for (auto& engine : engines) {
+        engine = make_search_engine({SIZE, SIZE}, options.depths[game / options.games], 1.0);
+        engine->set_evaluator(options.init);
+        engine->set_tt_size(4);
+        engine->new_game();
+    }
+    Bitboard<SIZE, SIZE> board;
+    std::vector<std::pair<int, int>> stones[2];
+    std::vector<float> counts(FEATURES, 0.0f);
+    std::vector<int> touched;
+
+    auto play = [&](std::pair<int, int> move, int side) {
+        board.place(move.first, move.second, side);
+        stones[side].push_back(move);
+        engines[0]->make_move(move, side == 0);
+        engines[1]->make_move(move, side == 1);
+    };
+
+    // Random opening near the centre
+    int side = 0;
+    play({SIZE / 2, SIZE / 2}, side);
+    side = 1;
+    while (static_cast<int>(stones[0].size() + stones[1].size()) < options.opening) {
+        int x = SIZE / 2 + static_cast<int>(rng() % 5) - 2;
+        int y = SIZE / 2 + static_cast<int>(rng() % 5) - 2;
+        if (board.is_empty(x, y)) {
+            play({x, y}, side);
+            side = 1 - side;
+        }
+    }
+
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    for (int stones_played = options.opening; stones_played < SIZE * SIZE; stones_played++) {
+        Sample sample;
+        sample.holdout = game % HOLDOUT_EVERY == 0;
+        add_features(board, side, counts, touched);
+        for (int p : touched) {
+            sample.features.push_back({p, counts[p]});
+            counts[p] = 0.0f;
+        }
+        touched.clear();
+
+        std::pair<int, int> move = engines[side]->get_next_move();
+        sample.label = label_of(engines[side]->get_search_stats().score);
+        samples.push_back(std::move(sample));
+        if (coin(rng) < options.explore) {
+            auto likely = engines[side]->likely_moves(stones[side], stones[1 - side], EXPLORE_MOVES);
+            if (!likely.empty()) {
+                move = likely[rng() % likely.size()];
+            }
+        }
+        play(move, side);
+        if (board.has_five(side)) {
+            break;
+        }
+        side = 1 - side;
+    }
+}
+
+template <int SIZE>
+static std::vector<Sample> play_games(const Options& options) {
+    std::vector<Sample> samples;
+    std::atomic<int> next_game(0);
+    std::atomic<int> finished(0);
+    std::mutex lock;
+
+    int games = options.games * static_cast<int>(options.depths.size());
+
+    auto worker = [&]() {
+        std::vector<Sample> local;
+        for (int game = next_game++; game < games; game = next_game++) {
+            play_game<SIZE>(options, game, local);
+            std::fprintf(stderr, "\r[%d/%d] games", ++finished, games);
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        samples.insert(samples.end(), std::make_move_iterator(local.begin()), std::make_move_iterator(local.end()));
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < std::min(options.jobs, games); i++) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::fprintf(stderr, "\n");
+    return samples;
+}
+
+// Mean log loss of a set of samples, in nats
+static double log_loss(const std::vector<Sample>& samples, const std::vector<double>& weights, bool holdout) {
+    double loss = 0;
+    int count = 0;
+    for (const Sample& sample : samples) {
+        if (sample.holdout != holdout) {
+            continue;
+        }
+        double z = 0;
+        for (const auto& [p, x] : sample.features) {
+            z += weights[p] * x;
+        }
+        double prob = std::clamp(1.0 / (1.0 + std::exp(-z / EVAL_SCALE)), 1e-9, 1.0 - 1e-9);
+        loss -= sample.label * std::log(prob) + (1 - sample.label) * std::log(1 - prob);
+        count++;
+    }
+    return count > 0 ? loss / count : 0.0;
+}
+
+// Full-batch Adam on the log loss; weights are in evaluation units
+static std::vector<double> fit(const std::vector<Sample>& samples, int epochs) {
+    std::vector<double> weights(FEATURES, 0.0);
+    std::vector<double> m(weights.size(), 0.0), v(weights.size(), 0.0), gradient(weights.size());
+    const double beta1 = 0.9, beta2 = 0.999;
+    int train_count = 0;
+    for (const Sample& sample : samples) {
+        train_count += !sample.holdout;
+    }
+
+    for (int epoch = 1; epoch <= epochs; epoch++) {
+        std::fill(gradient.begin(), gradient.end(), 0.0);
+        for (const Sample& sample : samples) {
+            if (sample.holdout) {
+                continue;
+            }
+            double z = 0;
+            for (const auto& [p, x] : sample.features) {
+                z += weights[p] * x;
+            }
+            double error = 1.0 / (1.0 + std::exp(-z / EVAL_SCALE)) - sample.label;
+            for (const auto& [p, x] : sample.features) {
+                gradient[p] += error * x;
+            }
+        }
+
+        // Adam in logit units, so the step size does not depend on EVAL_SCALE
+        double rate = LEARNING_RATE * 0.5 * (1 + std::cos(M_PI * (epoch - 1) / epochs));
+        for (std::size_t p = 0; p < weights.size(); p++) {
+            double g = gradient[p] / train_count + L2 * weights[p] / EVAL_SCALE;
+            m[p] = beta1 * m[p] + (1 - beta1) * g;
+            v[p] = beta2 * v[p] + (1 - beta2) * g * g;
+            double m_hat = m[p] / (1 - std::pow(beta1, epoch));
+            double v_hat = v[p] / (1 - std::pow(beta2, epoch));
+            weights[p] -= rate * EVAL_SCALE * m_hat / (std::sqrt(v_hat) + 1e-12);
+        }
+
+        if (epoch % 50 == 0 || epoch == epochs) {
+            std::fprintf(stderr, "epoch %4d  train loss %.4f  holdout loss %.4f\n", epoch,
+                         log_loss(samples, weights, false), log_loss(samples, weights, true));
+        }
+    }
+    return weights;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr,
+                     "usage: %s <out> [--games n] [--size 9|15|19] [--depths 2,3] [--opening n] [--explore p] "
+                     "[--epochs n] [--jobs n] [--seed n] [--init weights]\n",
+                     argv[0]);
+        return 1;
+    }
+    std::string out_path = argv[1];
+    Options options;
+
+    try {
+        for (int i = 2; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--games" && i + 1 < argc) {
+                options.games = std::atoi(argv[++i]);
+            } else if (arg == "--size" && i + 1 < argc) {
+                options.size = std::atoi(argv[++i]);
+            } else if (arg == "--depths" && i + 1 < argc) {
+                options.depths.clear();
+                std::stringstream list(argv[++i]);
+                std::string depth;
+                while (std::getline(list, depth, ',')) {
+                    options.depths.push_back(std::atoi(depth.c_str()));
+                }
+            } else if (arg == "--opening" && i + 1 < argc) {
+                options.opening = std::atoi(argv[++i]);
+            } else if (arg == "--explore" && i + 1 < argc) {
+                options.explore = std::atof(argv[++i]);
+            } else if (arg == "--epochs" && i + 1 < argc) {
+                options.epochs = std::atoi(argv[++i]);
+            } else if (arg == "--jobs" && i + 1 < argc) {
+                options.jobs = std::atoi(argv[++i]);
+            } else if (arg == "--seed" && i + 1 < argc) {
+                options.seed = std::strtoull(argv[++i], nullptr, 10);
+            } else if (arg == "--init" && i + 1 < argc) {
+                auto weights = std::make_shared<PatternWeights>();
+                if (!weights->load(argv[++i])) {
+                    std::fprintf(stderr, "[Error] Cannot open evaluation weights %s\n", argv[i]);
+                    return 1;
+                }
+                options.init = weights;
+            } else {
+                std::fprintf(stderr, "[Error] unknown argument '%s'\n", arg.c_str());
+                return 1;
+            }
+        }
+        bool depths_valid = !options.depths.empty() &&
+                            std::all_of(options.depths.begin(), options.depths.end(), [](int d) { return d >= 1; });
+        if (options.games < 1 || !depths_valid || options.opening < 1 || options.opening > 25 ||
+            options.explore < 0 || options.explore > 1 || options.epochs < 1 || options.jobs < 1 ||
+            (options.size != 9 && options.size != 15 && options.size != 19)) {
+            std::fprintf(stderr, "[Error] invalid arguments\n");
+            return 1;
+        }
+
+        std::vector<Sample> samples = options.size == 9    ? play_games<9>(options)
+                                      : options.size == 15 ? play_games<15>(options)
+                                                           : play_games<19>(options);
+        std::fprintf(stderr, "%zu positions\n", samples.size());
+
+        std::vector<double> fitted = fit(samples, options.epochs);
+
+        // Mirror images get the shared weight; int16 saturates, which no trained weight comes near
+        PatternWeights weights;
+        double largest = 0;
+        auto quantize = [&](double w) {
+            largest = std::max(largest, std::fabs(w));
+            return static_cast<int16_t>(std::clamp(std::lround(w), -32767L, 32767L));
+        };
+        for (int p = 0; p < PatternWeights::LINE_PATTERNS; p++) {
+            weights.line(p) = quantize(fitted[canonical(p)]);
+        }
+        for (int p = 0; p < PatternWeights::CELL_PATTERNS; p++) {
+            weights.cell(p) = quantize(fitted[PatternWeights::LINE_PATTERNS + p]);
+        }
+        weights.save(out_path);
+        std::printf("%s: %zu positions, largest weight %.0f\n", out_path.c_str(), samples.size(), largest);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,345 @@
+// Headless self-play tournament between two engine configurations.
+//
+// Every opening is a few random stones around the centre and is played
+// twice, once with each configuration as black, so neither side profits
+// from a lucky opening. Games run in parallel, one per worker thread, each
+// with fresh single-threaded engines. At the end the win/draw/loss record,
+// time per move and nodes/sec of both sides are printed.
+//
+// A configuration is a comma-separated list of key=value pairs:
+//   engine=minimax  minimax or mcts
+//   depth=3         fixed search depth (ignored when time > 0)
+//   playouts=20000  MCTS playouts per move (ignored when time > 0)
+//   time=0          ms per move, iterative deepening when > 0
+//   nodes=0         node (MCTS: playout) budget per move, 0 = none
+//   ratio=1.0       attack / defence ratio of the evaluation
+//   radius=1        candidate radius
+//   threats=1       VCF/VCT solver before the main search
+//   pvs=1           principal variation search
+//   aspiration=1    aspiration windows
+//   beam=0          moves searched per node, 0 = all
+//   root_beam=0     moves searched at the root, 0 = twice beam
+//   tt=16           transposition table in MB (MCTS node pool)
+//   eval=shapes     shapes, or a weight file for the learned pattern evaluator
+//
+// Usage: gomoku_selfplay [--a config] [--b config] [--games n] [--size 9|15|19]
+//                        [--jobs n] [--opening n] [--seed n]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "SearchEngine.hpp"
+#include "PatternWeights.hpp"
+
+struct Config {
+    std::string text;
+    EngineType engine = EngineType::Minimax;
+    int depth = 3;
+    int playouts = 20000;
+    int time_ms = 0;
+    uint64_t nodes = 0;
+    double ratio = 1.0;
+    int radius = 1;
+    bool threats = true;
+    bool pvs = true;
+    bool aspiration = true;
+    int beam = 0;
+    int root_beam = 0;
+    int tt_mb = 16;
+    std::shared_ptr<const PatternWeights> eval; // nullptr for shapes
+};
+
+// Per-side totals, summed over all games
+struct Record {
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+    long long moves = 0;
+    double time_ms = 0;
+    unsigned long long nodes = 0;
+};
+
+static Config parse_config(const std::string& text) {
+    Config config;
+    config.text = text.empty() ? "default" : text;
+    std::stringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        std::size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            throw std::invalid_argument("[Error] expected key=value, got '" + item + "'");
+        }
+        std::string key = item.substr(0, eq);
+        std::string value = item.substr(eq + 1);
+        if (key == "engine") {
+            if (value == "minimax") {
+                config.engine = EngineType::Minimax;
+            } else if (value == "mcts") {
+                config.engine = EngineType::Mcts;
+            } else {
+                throw std::invalid_argument("[Error] unknown engine '" + value + "'");
+            }
+        } else if (key == "depth") {
+            config.depth = std::atoi(value.c_str());
+        } else if (key == "playouts") {
+            config.playouts = std::atoi(value.c_str());
+        } else if (key == "time") {
+            config.time_ms = std::atoi(value.c_str());
+        } else if (key == "ratio") {
+            config.ratio = std::atof(value.c_str());
+        } else if (key == "radius") {
+            config.radius = std::atoi(value.c_str());
+        } else if (key == "threats") {
+            config.threats = std::atoi(value.c_str()) != 0;
+        } else if (key == "pvs") {
+            config.pvs = std::atoi(value.c_str()) != 0;
+        } else if (key == "aspiration") {
+            config.aspiration = std::atoi(value.c_str()) != 0;
+        } else if (key == "nodes") {
+            config.nodes = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "beam") {
+            config.beam = std::atoi(value.c_str());
+        } else if (key == "root_beam") {
+            config.root_beam = std::atoi(value.c_str());
+        } else if (key == "tt") {
+            config.tt_mb = std::atoi(value.c_str());
+        } else if (key == "eval") {
+            config.eval = nullptr;
+            if (value != "shapes") {
+                auto weights = std::make_shared<PatternWeights>();
+                if (!weights->load(value)) {
+                    throw std::invalid_argument("[Error] Cannot open evaluation weights " + value);
+                }
+                config.eval = weights;
+            }
+        } else {
+            throw std::invalid_argument("[Error] unknown config key '" + key + "'");
+        }
+    }
+    if (config.depth < 1 || config.playouts < 1 || config.time_ms < 0 || config.radius < 1 || config.beam < 0 ||
+        config.root_beam < 0 || config.tt_mb < 1) {
+        throw std::invalid_argument("[Error] invalid config '" + text + "'");
+    }
+    return config;
+}
+
+static std::unique_ptr<SearchEngine> make_engine(const Config& config, int size) {
+    auto engine = config.engine == EngineType::Mcts ? make_mcts_engine({size, size}, config.playouts, config.ratio)
+                                                    : make_search_engine({size, size}, config.depth, config.ratio);
+    engine->set_time_limit(config.time_ms);
+    engine->set_node_limit(config.nodes);
+    engine->set_candidate_radius(config.radius);
+    engine->set_threat_search(config.threats);
+    engine->set_pvs(config.pvs);
+    engine->set_aspiration(config.aspiration);
+    engine->set_beam(config.beam, config.root_beam);
+    engine->set_evaluator(config.eval);
+    engine->set_tt_size(config.tt_mb);
+    engine->new_game();
+    return engine;
+}
+
+// Random stones within two cells of the centre, black first, no two on one cell
+static std::vector<std::pair<int, int>> make_opening(int size, int stones, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::pair<int, int>> opening = {{size / 2, size / 2}};
+    while (static_cast<int>(opening.size()) < stones) {
+        std::pair<int, int> stone = {size / 2 + static_cast<int>(rng() % 5) - 2,
+                                     size / 2 + static_cast<int>(rng() % 5) - 2};
+        if (std::find(opening.begin(), opening.end(), stone) == opening.end()) {
+            opening.push_back(stone);
+        }
+    }
+    return opening;
+}
+
+// Stones of player in a row from (x, y) towards (dx, dy), not counting (x, y) itself
+static int count_line(const std::vector<int>& board, int size, int x, int y, int dx, int dy, int player) {
+    int count = 0;
+    for (int i = x + dx, j = y + dy; i >= 0 && i < size && j >= 0 && j < size && board[i * size + j] == player;
+         i += dx, j += dy) {
+        count++;
+    }
+    return count;
+}
+
+static bool makes_five(const std::vector<int>& board, int size, int x, int y, int player) {
+    static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    for (const auto& d : directions) {
+        if (1 + count_line(board, size, x, y, d[0], d[1], player) +
+                count_line(board, size, x, y, -d[0], -d[1], player) >= 5) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// One game; returns the winning side (0 = A, 1 = B) or -1 for a draw
+static int play_game(const Config configs[2], int size, const std::vector<std::pair<int, int>>& opening,
+                     int black, Record records[2]) {
+    std::unique_ptr<SearchEngine> engines[2] = {make_engine(configs[0], size), make_engine(configs[1], size)};
+    std::vector<int> board(size * size, 0); // 0 empty, 1 + side otherwise
+
+    auto play = [&](std::pair<int, int> move, int side) {
+        board[move.first * size + move.second] = 1 + side;
+        engines[0]->make_move(move, side == 0);
+        engines[1]->make_move(move, side == 1);
+    };
+
+    int side = black;
+    for (const auto& stone : opening) {
+        play(stone, side);
+        side = 1 - side;
+    }
+
+    for (int stones = static_cast<int>(opening.size()); stones < size * size; stones++) {
+        auto start = std::chrono::steady_clock::now();
+        std::pair<int, int> move = engines[side]->get_next_move();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        Record& record = records[side];
+        record.moves++;
+        record.time_ms += ms;
+        record.nodes += engines[side]->get_search_stats().nodes;
+
+        // An illegal move forfeits the game
+        if (move.first < 0 || move.first >= size || move.second < 0 || move.second >= size ||
+            board[move.first * size + move.second] != 0) {
+            std::fprintf(stderr, "[Error] side %c played illegal move (%d, %d)\n", 'A' + side, move.first,
+                         move.second);
+            return 1 - side;
+        }
+
+        play(move, side);
+        if (makes_five(board, size, move.first, move.second, 1 + side)) {
+            return side;
+        }
+        side = 1 - side;
+    }
+    return -1;
+}
+
+static void print_side(const char* name, const Config& config, const Record& record) {
+    std::printf("%-4s %-40s %5d %5d %5d %10.2f %12.0f\n", name, config.text.c_str(), record.wins, record.draws,
+                record.losses, record.moves > 0 ? record.time_ms / record.moves : 0.0,
+                record.time_ms > 0 ? record.nodes * 1000.0 / record.time_ms : 0.0);
+}
+
+int main(int argc, char** argv) {
+    std::string texts[2];
+    int games = 100;
+    int size = 15;
+    int jobs = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int opening_stones = 3;
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--a" && i + 1 < argc) {
+            texts[0] = argv[++i];
+        } else if (arg == "--b" && i + 1 < argc) {
+            texts[1] = argv[++i];
+        } else if (arg == "--games" && i + 1 < argc) {
+            games = std::atoi(argv[++i]);
+        } else if (arg == "--size" && i + 1 < argc) {
+            size = std::atoi(argv[++i]);
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = std::atoi(argv[++i]);
+        } else if (arg == "--opening" && i + 1 < argc) {
+            opening_stones = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--a config] [--b config] [--games n] [--size 9|15|19] [--jobs n] "
+                         "[--opening n] [--seed n]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+    if (games < 1 || jobs < 1 || opening_stones < 1 || opening_stones > 25 || !search_engine_supports(size, size)) {
+        std::fprintf(stderr, "[Error] invalid arguments\n");
+        return 1;
+    }
+
+    Config configs[2];
+    try {
+        configs[0] = parse_config(texts[0]);
+        configs[1] = parse_config(texts[1]);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    // Games 2k and 2k + 1 share opening k with colours swapped
+    Record records[2];
+    std::atomic<int> next_game(0);
+    std::atomic<int> finished(0);
+    std::mutex lock;
+    auto started = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        for (int game = next_game++; game < games; game = next_game++) {
+            auto opening = make_opening(size, opening_stones, seed * 1000003 + game / 2);
+            int black = game & 1;
+            Record game_records[2];
+            int winner = play_game(configs, size, opening, black, game_records);
+
+            std::lock_guard<std::mutex> guard(lock);
+            for (int side = 0; side < 2; side++) {
+                Record& record = records[side];
+                record.moves += game_records[side].moves;
+                record.time_ms += game_records[side].time_ms;
+                record.nodes += game_records[side].nodes;
+                record.wins += winner == side;
+                record.losses += winner == 1 - side;
+                record.draws += winner < 0;
+            }
+            std::fprintf(stderr, "\r[%d/%d] A %d - %d B (%d draws)", ++finished, games, records[0].wins,
+                         records[1].wins, records[0].draws);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < std::min(jobs, games); i++) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::fprintf(stderr, "\n");
+
+    std::printf("%d games on %dx%d, %d opening stones, %d jobs, %.1f s\n\n", games, size, size, opening_stones,
+                std::min(jobs, games), seconds);
+    std::printf("%-4s %-40s %5s %5s %5s %10s %12s\n", "side", "config", "win", "draw", "loss", "ms/move",
+                "nodes/sec");
+    print_side("A", configs[0], records[0]);
+    print_side("B", configs[1], records[1]);
+
+    // Elo difference of A over B from the score, undefined at 0% and 100%
+    double score = (records[0].wins + 0.5 * records[0].draws) / games;
+    std::printf("\nscore A: %.1f%%", score * 100);
+    if (score > 0 && score < 1) {
+        std::printf(", Elo difference %+.0f", -400 * std::log10(1 / score - 1) + 0.0);
+    }
+    std::printf("\n");
+    if (!GOMOKU_SEARCH_STATS) {
+        std::printf("(nodes/sec needs a build with GOMOKU_SEARCH_STATS)\n");
+    }
+    return 0;
+}